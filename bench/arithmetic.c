@@ -0,0 +1,144 @@
+/*
+ * Copyright 2025 Guillermo Calvo
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <math.h>
+#include <time.h>
+#include <exceptions4c-lite-arithmetic.h>
+
+struct e4c_context exceptions4c = {0};
+const e4c_exception_type ARITHMETIC_OVERFLOW = "Arithmetic overflow";
+
+#define LENGTH 4096
+#define ROUNDS 20000
+
+/* Staggers the arrays so that their addresses don't alias modulo 4 KiB */
+#define ARRAYS(type, a, b, result)                                          \
+  static type a##_buffer[3 * LENGTH + 48];                                  \
+  static type *const a = a##_buffer;                                        \
+  static type *const b = a##_buffer + LENGTH + 16;                          \
+  static type *const result = a##_buffer + 2 * LENGTH + 48
+
+ARRAYS(int32_t, a32, b32, result32);
+ARRAYS(int64_t, a64, b64, result64);
+ARRAYS(float, a_float, b_float, result_float);
+static volatile double sink;
+
+static void branchy_add_int32(void) {
+    for (size_t index = 0; index < LENGTH; index++) {
+        if (__builtin_add_overflow(a32[index], b32[index], &result32[index])) {
+            THROW(ARITHMETIC_OVERFLOW, NULL);
+        }
+    }
+}
+
+static void kernel_add_int32(void) {
+    CHECKED_ADD_ARRAY(result32, a32, b32, LENGTH);
+}
+
+static void branchy_mul_int32(void) {
+    for (size_t index = 0; index < LENGTH; index++) {
+        if (__builtin_mul_overflow(a32[index], b32[index], &result32[index])) {
+            THROW(ARITHMETIC_OVERFLOW, NULL);
+        }
+    }
+}
+
+static void kernel_mul_int32(void) {
+    CHECKED_MUL_ARRAY(result32, a32, b32, LENGTH);
+}
+
+static void branchy_add_int64(void) {
+    for (size_t index = 0; index < LENGTH; index++) {
+        if (__builtin_add_overflow(a64[index], b64[index], &result64[index])) {
+            THROW(ARITHMETIC_OVERFLOW, NULL);
+        }
+    }
+}
+
+static void kernel_add_int64(void) {
+    CHECKED_ADD_ARRAY(result64, a64, b64, LENGTH);
+}
+
+static void branchy_mul_int64(void) {
+    for (size_t index = 0; index < LENGTH; index++) {
+        if (__builtin_mul_overflow(a64[index], b64[index], &result64[index])) {
+            THROW(ARITHMETIC_OVERFLOW, NULL);
+        }
+    }
+}
+
+static void kernel_mul_int64(void) {
+    CHECKED_MUL_ARRAY(result64, a64, b64, LENGTH);
+}
+
+static void branchy_add_float(void) {
+    for (size_t index = 0; index < LENGTH; index++) {
+        result_float[index] = a_float[index] + b_float[index];
+        if (!isfinite(result_float[index])) {
+            THROW(ARITHMETIC_OVERFLOW, NULL);
+        }
+    }
+}
+
+static void kernel_add_float(void) {
+    CHECKED_ADD_ARRAY(result_float, a_float, b_float, LENGTH);
+}
+
+static void branchy_sum_int32(void) {
+    int32_t sum = 0;
+    for (size_t index = 0; index < LENGTH; index++) {
+        if (__builtin_add_overflow(sum, a32[index], &sum)) {
+            THROW(ARITHMETIC_OVERFLOW, NULL);
+        }
+    }
+    sink = sum;
+}
+
+static void kernel_sum_int32(void) {
+    sink = CHECKED_SUM(a32, LENGTH);
+}
+
+static double measure(void (*function)(void)) {
+    clock_t start = clock();
+    for (int round = 0; round < ROUNDS; round++) {
+        function();
+    }
+    return (double) (clock() - start) * 1e9 / CLOCKS_PER_SEC / ROUNDS / LENGTH;
+}
+
+static void compare(const char *name, void (*branchy)(void),
+    void (*kernel)(void)) {
+    printf("%-12s %14.3f %14.3f\n", name, measure(branchy), measure(kernel));
+}
+
+/**
+ * Compares the checked array kernels with a branch per element.
+ */
+int main(void) {
+    for (size_t index = 0; index < LENGTH; index++) {
+        a32[index] = b32[index] = (int32_t) (index % 1000);
+        a64[index] = b64[index] = (int64_t) index * 1000;
+        a_float[index] = b_float[index] = (float) index / 3;
+    }
+    printf("%-12s %14s %14s\n", "operation", "branchy (ns)", "kernel (ns)");
+    compare("add int32", branchy_add_int32, kernel_add_int32);
+    compare("mul int32", branchy_mul_int32, kernel_mul_int32);
+    compare("add int64", branchy_add_int64, kernel_add_int64);
+    compare("mul int64", branchy_mul_int64, kernel_mul_int64);
+    compare("add float", branchy_add_float, kernel_add_float);
+    compare("sum int32", branchy_sum_int32, kernel_sum_int32);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,77 @@
+/*
+ * Copyright 2025 Guillermo Calvo
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <time.h>
+#include <exceptions4c-lite.h>
+
+struct e4c_context exceptions4c = {0};
+const e4c_exception_type BAD_RECORD = "Bad record";
+
+#define LENGTH 1000000
+#define FAILURES 64
+
+static int records[LENGTH];
+static volatile long output[LENGTH];
+
+static long transform(int record) {
+    if (record < 0) {
+        THROW(BAD_RECORD, NULL);
+    }
+    return (long) record * 3 + 1;
+}
+
+static size_t per_record(void) {
+    size_t failed = 0;
+    for (size_t index = 0; index < LENGTH; index++) {
+        TRY {
+            output[index] = transform(records[index]);
+        } CATCH (BAD_RECORD) {
+            failed++;
+        }
+    }
+    return failed;
+}
+
+static size_t batched(void) {
+    static struct e4c_batch_failure failures[FAILURES];
+    struct e4c_batch batch = {failures, FAILURES};
+    size_t index;
+    BATCH_TRY (index, LENGTH, &batch) {
+        output[index] = transform(records[index]);
+    }
+    return batch.failed;
+}
+
+static double measure(size_t (*function)(void), size_t *failed) {
+    clock_t start = clock();
+    *failed = function();
+    return (double) (clock() - start) * 1e9 / CLOCKS_PER_SEC / LENGTH;
+}
+
+/**
+ * Compares a TRY per record with a single BATCH_TRY, with 0.1% of failures.
+ */
+int main(void) {
+    size_t failed;
+    for (size_t index = 0; index < LENGTH; index++) {
+        records[index] = index % 1000 == 999 ? -1 : (int) (index % 1000);
+    }
+    printf("%-20s %10.3f ns/record", "TRY per record", measure(per_record, &failed));
+    printf(" (%lu failed)\n", (unsigned long) failed);
+    printf("%-20s %10.3f ns/record", "BATCH_TRY", measure(batched, &failed));
+    printf(" (%lu failed)\n", (unsigned long) failed);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,95 @@
+/*
+ * Copyright 2025 Guillermo Calvo
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define EXCEPTIONS4C_CANCELLATION 1
+#define EXCEPTIONS4C_THREAD_LOCAL _Thread_local
+#include <time.h>
+#include <exceptions4c-lite.h>
+
+EXCEPTIONS4C_THREAD_LOCAL struct e4c_context exceptions4c = {0};
+const e4c_exception_type CANCELLED = "Cancelled";
+
+#define ITERATIONS 200000000UL
+
+static unsigned long plain_loop(unsigned long seed) {
+    unsigned long value = seed;
+    for (unsigned long iteration = 0; iteration < ITERATIONS; iteration++) {
+        value = value * 6364136223846793005UL + 1442695040888963407UL;
+    }
+    return value;
+}
+
+static unsigned long checkpoint_loop(unsigned long seed) {
+    unsigned long value = seed;
+    for (unsigned long iteration = 0; iteration < ITERATIONS; iteration++) {
+        CHECKPOINT();
+        value = value * 6364136223846793005UL + 1442695040888963407UL;
+    }
+    return value;
+}
+
+#define LENGTH 4096
+#define STRIDE 17
+
+static unsigned long array[LENGTH];
+
+/* Independent iterations, so that the cost of CHECKPOINT isn't hidden */
+static unsigned long plain_sum(unsigned long seed) {
+    unsigned long sum = seed;
+    for (unsigned long iteration = 0; iteration < ITERATIONS; iteration++) {
+        sum += array[(iteration * STRIDE) % LENGTH];
+    }
+    return sum;
+}
+
+static unsigned long checkpoint_sum(unsigned long seed) {
+    unsigned long sum = seed;
+    for (unsigned long iteration = 0; iteration < ITERATIONS; iteration++) {
+        CHECKPOINT();
+        sum += array[(iteration * STRIDE) % LENGTH];
+    }
+    return sum;
+}
+
+static double measure(unsigned long (*loop)(unsigned long), unsigned long *result) {
+    clock_t start = clock();
+    *result ^= loop(*result);
+    return (double) (clock() - start) * 1e9 / CLOCKS_PER_SEC / ITERATIONS;
+}
+
+static void compare(const char *name, unsigned long (*plain)(unsigned long),
+    unsigned long (*checkpoint)(unsigned long), unsigned long *result) {
+    double before = measure(plain, result);
+    double after = measure(checkpoint, result);
+    printf("%-24s %10.3f %10.3f %10.3f\n", name, before, after, after - before);
+}
+
+/**
+ * Measures the overhead of CHECKPOINT in a latency-bound loop, where it can
+ * hide behind a chain of multiplications, and in a throughput-bound one.
+ */
+int main(void) {
+    unsigned long result = (unsigned long) time(NULL);
+    for (size_t index = 0; index < LENGTH; index++) {
+        array[index] = index * result;
+    }
+    printf("%-24s %10s %10s %10s (ns/iteration)\n", "loop", "plain",
+        "CHECKPOINT", "overhead");
+    compare("dependency chain", plain_loop, checkpoint_loop, &result);
+    compare("strided sum", plain_sum, checkpoint_sum, &result);
+    printf("(checksum %lu)\n", result);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,60 @@
+/*
+ * Copyright 2025 Guillermo Calvo
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Generates SITES functions containing either nothing (SITE_NONE), one TRY
+ * block (SITE_TRY) or one THROW (SITE_THROW). Compiled by code-size.sh to
+ * compute the number of bytes per site.
+ */
+
+#include <exceptions4c-lite.h>
+
+extern const e4c_exception_type OOPS;
+extern void work(int value);
+
+#if defined(SITE_TRY)
+# define SITE(n)                                                            \
+  void site_##n(void) {                                                     \
+    TRY {                                                                   \
+      work(n);                                                              \
+    } CATCH (OOPS) {                                                        \
+      work(-n);                                                             \
+    }                                                                       \
+  }
+#elif defined(SITE_THROW)
+# define SITE(n)                                                            \
+  void site_##n(int value) {                                                \
+    if (value) {                                                            \
+      THROW(OOPS, "Oops");                                                  \
+    }                                                                       \
+    work(n);                                                                \
+  }
+#else
+# define SITE(n)                                                            \
+  void site_##n(int value) {                                                \
+    if (value) {                                                            \
+      work(-n);                                                             \
+    }                                                                       \
+    work(n);                                                                \
+  }
+#endif
+
+#define SITES8(n)                                                           \
+  SITE(n##0) SITE(n##1) SITE(n##2) SITE(n##3)                               \
+  SITE(n##4) SITE(n##5) SITE(n##6) SITE(n##7)
+
+SITES8(1) SITES8(2) SITES8(3) SITES8(4)
+SITES8(5) SITES8(6) SITES8(7) SITES8(8)
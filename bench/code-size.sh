@@ -0,0 +1,37 @@
+#!/bin/sh
+#
+# exceptions4c-lite
+#
+# Copyright (c) 2025 Guillermo Calvo
+# Licensed under the Apache License, Version 2.0
+#
+# Reports the number of bytes of code generated per TRY site and per THROW
+# site, with and without EXCEPTIONS4C_OUT_OF_LINE.
+#
+# Usage: code-size.sh SOURCE_DIR [CC [CFLAGS...]]
+#
+
+srcdir=${1:-.}
+shift
+cc=${1:-cc}
+[ $# -gt 0 ] && shift
+sites=64
+object=$(mktemp)
+
+text_size() {
+    $cc "$@" -I"$srcdir/src" -c "$srcdir/bench/code-size.c" -o "$object" || exit 1
+    size "$object" | awk 'NR == 2 { print $1 }'
+}
+
+printf '%-28s %12s %12s\n' "mode" "TRY (bytes)" "THROW (bytes)"
+for mode in 0 1; do
+    for debug in "" "-DNDEBUG"; do
+        none=$(text_size "$@" $debug -DEXCEPTIONS4C_OUT_OF_LINE=$mode -DSITE_NONE)
+        try=$(text_size "$@" $debug -DEXCEPTIONS4C_OUT_OF_LINE=$mode -DSITE_TRY)
+        throw=$(text_size "$@" $debug -DEXCEPTIONS4C_OUT_OF_LINE=$mode -DSITE_THROW)
+        printf '%-28s %12d %12d\n' "OUT_OF_LINE=$mode ${debug:-(debug)}" \
+            $(( (try - none) / sites )) $(( (throw - none) / sites ))
+    done
+done
+
+rm -f "$object"
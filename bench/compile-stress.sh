@@ -0,0 +1,69 @@
+#!/bin/sh
+#
+# exceptions4c-lite
+#
+# Copyright (c) 2025 Guillermo Calvo
+# Licensed under the Apache License, Version 2.0
+#
+# Generates a translation unit with many TRY/CATCH/FINALLY/THROW sites and
+# reports the preprocessed size, preprocessing and compile time, and object
+# size, with and without EXCEPTIONS4C_OUT_OF_LINE.
+#
+# Usage: compile-stress.sh SOURCE_DIR [CC [CFLAGS...]]
+#
+
+srcdir=${1:-.}
+shift
+cc=${1:-cc}
+[ $# -gt 0 ] && shift
+sites=${SITES:-10000}
+directory=$(mktemp -d)
+source="$directory/stress.c"
+
+awk -v sites="$sites" 'BEGIN {
+    print "#include <exceptions4c-lite.h>"
+    print "extern const e4c_exception_type OOPS;"
+    print "extern void work(int value);"
+    for (n = 0; n < sites; n++) {
+        print "void site_" n "(int value) {"
+        print "    TRY {"
+        print "        if (value == " n ") {"
+        print "            THROW(OOPS, \"Site " n "\");"
+        print "        }"
+        print "        work(value);"
+        print "    } CATCH (OOPS) {"
+        print "        work(-value);"
+        print "    } FINALLY {"
+        print "        work(0);"
+        print "    }"
+        print "}"
+    }
+}' > "$source"
+
+now() {
+    date +%s%N
+}
+
+milliseconds() {
+    echo $(( ($2 - $1) / 1000000 ))
+}
+
+printf '%d sites\n' "$sites"
+printf '%-14s %12s %10s %12s %12s %12s\n' "mode" "tokens/site" "cpp (ms)" \
+    "compile (ms)" "text (bytes)" "bytes/site"
+for mode in 0 1; do
+    flags="-I$srcdir/src -DEXCEPTIONS4C_OUT_OF_LINE=$mode"
+    start=$(now)
+    $cc "$@" $flags -E -P "$source" -o "$directory/stress.i" || exit 1
+    preprocessed=$(now)
+    $cc "$@" $flags -c "$source" -o "$directory/stress.o" || exit 1
+    compiled=$(now)
+    tokens=$(grep -oE '[A-Za-z_][A-Za-z0-9_]*|[0-9.]+|"([^"\\]|\\.)*"|->|[-+&|<>=!]=?|[^[:space:]]' \
+        "$directory/stress.i" | wc -l)
+    text=$(size "$directory/stress.o" | awk 'NR == 2 { print $1 }')
+    printf '%-14s %12d %10d %12d %12d %12d\n' "OUT_OF_LINE=$mode" \
+        $(( tokens / sites )) $(milliseconds "$start" "$preprocessed") \
+        $(milliseconds "$preprocessed" "$compiled") "$text" $(( text / sites ))
+done
+
+rm -rf "$directory"
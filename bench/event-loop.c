@@ -0,0 +1,97 @@
+/*
+ * Copyright 2025 Guillermo Calvo
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <time.h>
+#include "../examples/event-loop.h"
+
+struct e4c_context exceptions4c = {0};
+const e4c_exception_type PROTOCOL_ERROR = "Protocol error";
+
+#define EVENTS 10000
+#define ITERATIONS 500
+
+static struct connection connections[EVENTS];
+static struct connection *ready[EVENTS];
+static volatile long handled;
+static volatile long errors;
+static int failing;
+
+static void on_event(struct connection *connection) {
+    if (failing && connection->fd % 100 == 0) {
+        THROW(PROTOCOL_ERROR, NULL);
+    }
+    handled++;
+}
+
+static void on_error(struct connection *connection,
+    const struct e4c_exception *exception) {
+    (void) connection;
+    (void) exception;
+    errors++;
+}
+
+static void dispatch_per_event(struct event_loop *loop) {
+    (void) loop;
+    for (size_t index = 0; index < EVENTS; index++) {
+        TRY {
+            ready[index]->on_event(ready[index]);
+        } CATCH_ALL {
+            ready[index]->on_error(ready[index], &EXCEPTION);
+        }
+    }
+}
+
+static void dispatch_batch(struct event_loop *loop) {
+    (void) event_loop_dispatch(loop, ready, EVENTS);
+}
+
+static void measure(const char *name, void (*dispatch)(struct event_loop *),
+    struct event_loop *loop) {
+    clock_t start = clock();
+    double elapsed;
+    handled = errors = 0;
+    for (int iteration = 0; iteration < ITERATIONS; iteration++) {
+        dispatch(loop);
+    }
+    elapsed = (double) (clock() - start) / CLOCKS_PER_SEC;
+    printf("%-24s %10.3f ns/event %8.2f Mevents/s (%ld errors)\n", name,
+        elapsed * 1e9 / ((double) ITERATIONS * EVENTS),
+        (double) ITERATIONS * EVENTS / elapsed / 1e6, (long) errors);
+}
+
+/**
+ * Compares a TRY per callback with the event loop adapter, dispatching 10k
+ * events per iteration with clean callbacks and with 1% failing callbacks.
+ */
+int main(void) {
+    struct event_loop loop;
+    if (!event_loop_init(&loop, EVENTS)) {
+        return EXIT_FAILURE;
+    }
+    for (int index = 0; index < EVENTS; index++) {
+        connections[index].fd = index;
+        connections[index].on_event = on_event;
+        connections[index].on_error = on_error;
+        ready[index] = &connections[index];
+    }
+    for (failing = 0; failing <= 1; failing++) {
+        printf("-- %s callbacks\n", failing ? "1% failing" : "clean");
+        measure("TRY per callback", dispatch_per_event, &loop);
+        measure("event loop adapter", dispatch_batch, &loop);
+    }
+    event_loop_free(&loop);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,91 @@
+/*
+ * Copyright 2025 Guillermo Calvo
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define EXCEPTIONS4C_FAULT_INJECTION 1
+
+#include <time.h>
+#include <exceptions4c-lite.h>
+
+struct e4c_context exceptions4c = {0};
+const e4c_exception_type IO_ERROR = "I/O error";
+
+#define REQUESTS 200000
+
+static double latency[REQUESTS];
+static long acquired;
+static long released;
+static volatile unsigned long work;
+
+static void handle(int request) {
+    for (int step = 0; step < 64; step++) {
+        work += (unsigned long) (request ^ step);
+    }
+    if (FAULT_INJECTED(IO_ERROR)) {
+        THROW(IO_ERROR, "Injected");
+    }
+}
+
+static double now(void) {
+    struct timespec time;
+    (void) clock_gettime(CLOCK_MONOTONIC, &time);
+    return (double) time.tv_sec * 1e9 + (double) time.tv_nsec;
+}
+
+static int compare(const void *a, const void *b) {
+    double x = *(const double *) a, y = *(const double *) b;
+    return (x > y) - (x < y);
+}
+
+static void measure(const char *spec) {
+    volatile long failed = 0;
+    double start, elapsed;
+    if (!INJECT_FAULTS(spec)) {
+        printf("Invalid specification: %s\n", spec);
+        exit(EXIT_FAILURE);
+    }
+    acquired = released = 0;
+    start = now();
+    for (int request = 0; request < REQUESTS; request++) {
+        double begin = now();
+        TRY {
+            acquired++;
+            handle(request);
+        } CATCH (IO_ERROR) {
+            failed++;
+        } FINALLY {
+            released++;
+        }
+        latency[request] = now() - begin;
+    }
+    elapsed = now() - start;
+    qsort(latency, REQUESTS, sizeof(latency[0]), compare);
+    printf("%-18s %7.2f Mreq/s  p50 %6.0f ns  p99 %6.0f ns  p99.9 %6.0f ns"
+        "  (%ld failed, %s)\n", spec[0] ? spec : "(none)",
+        REQUESTS / elapsed * 1e3, latency[REQUESTS / 2],
+        latency[REQUESTS / 100 * 99], latency[REQUESTS / 1000 * 999],
+        (long) failed, acquired == released ? "all released" : "LEAKED");
+}
+
+/**
+ * Measures throughput and tail latency with 0.1%, 1% and 10% injected faults.
+ */
+int main(void) {
+    measure("");
+    measure("probability=0.001");
+    measure("probability=0.01");
+    measure("probability=0.1");
+    return acquired == released ? EXIT_SUCCESS : EXIT_FAILURE;
+}
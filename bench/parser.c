@@ -0,0 +1,482 @@
+/*
+ * Copyright 2025 Guillermo Calvo
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string.h>
+#include <time.h>
+#include <exceptions4c-lite.h>
+
+struct e4c_context exceptions4c = {0};
+const e4c_exception_type SYNTAX_ERROR = "Syntax error";
+
+/*
+ * Parses a generated corpus of JSON documents twice: once with a recursive
+ * descent parser that throws exceptions, and once with an equivalent parser
+ * that propagates error codes by hand. Both parsers sum every number they
+ * find, so that they do the same amount of work.
+ */
+
+#define DOCUMENTS 8000
+#define DOCUMENT_SIZE 2048
+#define MAX_DEPTH 64
+#define ROUNDS 20
+
+struct corpus {
+    char *text;
+    size_t length;
+    size_t document[DOCUMENTS + 1];
+};
+
+struct parser {
+    const char *next;
+    const char *end;
+    char error[64];
+};
+
+static unsigned long long random_state = 88172645463325252ULL;
+static const char *document_limit;
+
+static unsigned long random_next(void) {
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 7;
+    random_state ^= random_state << 17;
+    return (unsigned long) (random_state >> 16);
+}
+
+/* Corpus generation */
+
+static void generate_value(char **out, int depth);
+
+static void generate_string(char **out) {
+    static const char *const words[] = {
+        "id", "name", "status", "price", "tags", "owner", "items", "created"
+    };
+    *out += sprintf(*out, "\"%s\"", words[random_next() % 8]);
+}
+
+static void generate_value(char **out, int depth) {
+    unsigned long kind = depth < 3 ? 4 + random_next() % 2
+        : depth >= 12 || *out > document_limit ? random_next() % 4
+        : random_next() % 6;
+    int count = 1 + (int) (random_next() % 6);
+    switch (kind) {
+    case 0:
+        *out += sprintf(*out, "%lu.%02lu", random_next() % 100000,
+            random_next() % 100);
+        break;
+    case 1:
+        generate_string(out);
+        break;
+    case 2:
+        *out += sprintf(*out, "%s", random_next() % 2 ? "true" : "null");
+        break;
+    case 3:
+        *out += sprintf(*out, "-%lu", random_next() % 1000);
+        break;
+    case 4:
+        *(*out)++ = '[';
+        for (int index = 0; index < count; index++) {
+            if (index > 0) {
+                *(*out)++ = ',';
+            }
+            generate_value(out, depth + 1);
+        }
+        *(*out)++ = ']';
+        break;
+    default:
+        *(*out)++ = '{';
+        for (int index = 0; index < count; index++) {
+            if (index > 0) {
+                *(*out)++ = ',';
+            }
+            generate_string(out);
+            *(*out)++ = ':';
+            generate_value(out, depth + 1);
+        }
+        *(*out)++ = '}';
+        break;
+    }
+}
+
+static void generate_corpus(struct corpus *corpus) {
+    char *out;
+    corpus->text = malloc((size_t) DOCUMENTS * DOCUMENT_SIZE * 2);
+    out = corpus->text;
+    for (int index = 0; index < DOCUMENTS; index++) {
+        corpus->document[index] = (size_t) (out - corpus->text);
+        document_limit = out + DOCUMENT_SIZE;
+        *out++ = '{';
+        generate_string(&out);
+        *out++ = ':';
+        generate_value(&out, 0);
+        *out++ = '}';
+    }
+    corpus->document[DOCUMENTS] = (size_t) (out - corpus->text);
+    corpus->length = (size_t) (out - corpus->text);
+}
+
+/* Replaces a structural character of some documents so they fail to parse */
+static void corrupt_corpus(struct corpus *corpus, const char *original,
+    double ratio) {
+    memcpy(corpus->text, original, corpus->length);
+    for (int index = 0; index < DOCUMENTS; index++) {
+        size_t start = corpus->document[index];
+        size_t length = corpus->document[index + 1] - start;
+        size_t position = start + random_next() % length;
+        if ((double) (random_next() % 1000000) >= ratio * 1000000) {
+            continue;
+        }
+        while (strchr("{}[]:,", corpus->text[position]) == NULL) {
+            position = position + 1 < start + length ? position + 1 : start;
+        }
+        corpus->text[position] = '@';
+    }
+}
+
+/* Scans a number, returning NULL if there is none */
+static const char *scan_number(const char *next, const char *end,
+    double *number) {
+    double value = 0, scale = 1;
+    int negative = next < end && *next == '-';
+    const char *start = negative ? ++next : next;
+    while (next < end && *next >= '0' && *next <= '9') {
+        value = value * 10 + (*next++ - '0');
+    }
+    if (next < end && *next == '.') {
+        while (++next < end && *next >= '0' && *next <= '9') {
+            value = value * 10 + (*next - '0');
+            scale *= 10;
+        }
+    }
+    *number = negative ? -value / scale : value / scale;
+    return next == start ? NULL : next;
+}
+
+/* Exception-based parser */
+
+static double parse_value(struct parser *parser, int depth);
+
+static void skip_space(struct parser *parser) {
+    while (parser->next < parser->end && *parser->next == ' ') {
+        parser->next++;
+    }
+}
+
+static void expect(struct parser *parser, char character) {
+    skip_space(parser);
+    if (parser->next >= parser->end || *parser->next != character) {
+        THROWF(SYNTAX_ERROR, "Expected '%c'", character);
+    }
+    parser->next++;
+}
+
+static void parse_string(struct parser *parser) {
+    expect(parser, '"');
+    while (parser->next < parser->end && *parser->next != '"') {
+        parser->next++;
+    }
+    expect(parser, '"');
+}
+
+static double parse_number(struct parser *parser) {
+    double number;
+    const char *end = scan_number(parser->next, parser->end, &number);
+    if (end == NULL) {
+        THROW(SYNTAX_ERROR, "Invalid number");
+    }
+    parser->next = end;
+    return number;
+}
+
+static double parse_literal(struct parser *parser, const char *literal,
+    size_t length) {
+    if ((size_t) (parser->end - parser->next) < length
+        || memcmp(parser->next, literal, length) != 0) {
+        THROW(SYNTAX_ERROR, "Invalid literal");
+    }
+    parser->next += length;
+    return 0;
+}
+
+static double parse_array(struct parser *parser, int depth) {
+    double sum = 0;
+    expect(parser, '[');
+    do {
+        sum += parse_value(parser, depth + 1);
+        skip_space(parser);
+    } while (parser->next < parser->end && *parser->next == ','
+        && parser->next++);
+    expect(parser, ']');
+    return sum;
+}
+
+static double parse_object(struct parser *parser, int depth) {
+    double sum = 0;
+    expect(parser, '{');
+    do {
+        parse_string(parser);
+        expect(parser, ':');
+        sum += parse_value(parser, depth + 1);
+        skip_space(parser);
+    } while (parser->next < parser->end && *parser->next == ','
+        && parser->next++);
+    expect(parser, '}');
+    return sum;
+}
+
+static double parse_value(struct parser *parser, int depth) {
+    if (depth > MAX_DEPTH) {
+        THROWF(SYNTAX_ERROR, "Too deep: %d", depth);
+    }
+    skip_space(parser);
+    if (parser->next >= parser->end) {
+        THROW(SYNTAX_ERROR, "Unexpected end of document");
+    }
+    switch (*parser->next) {
+    case '{':
+        return parse_object(parser, depth);
+    case '[':
+        return parse_array(parser, depth);
+    case '"':
+        parse_string(parser);
+        return 0;
+    case 't':
+        return parse_literal(parser, "true", 4);
+    case 'n':
+        return parse_literal(parser, "null", 4);
+    default:
+        return parse_number(parser);
+    }
+}
+
+static double parse_with_exceptions(const struct corpus *corpus,
+    long *errors) {
+    volatile double sum = 0;
+    volatile long failed = 0;
+    for (int index = 0; index < DOCUMENTS; index++) {
+        struct parser parser = {
+            corpus->text + corpus->document[index],
+            corpus->text + corpus->document[index + 1]
+        };
+        TRY {
+            double value = parse_value(&parser, 0);
+            skip_space(&parser);
+            if (parser.next != parser.end) {
+                THROW(SYNTAX_ERROR, "Trailing characters");
+            }
+            sum += value;
+        } CATCH (SYNTAX_ERROR) {
+            failed++;
+        }
+    }
+    *errors = failed;
+    return sum;
+}
+
+/* Error-code-based parser */
+
+enum status { OK, SYNTAX };
+
+static enum status parse_value_rc(struct parser *parser, int depth,
+    double *sum);
+
+static enum status fail(struct parser *parser, const char *message,
+    int detail) {
+    (void) snprintf(parser->error, sizeof(parser->error), message, detail);
+    return SYNTAX;
+}
+
+static enum status expect_rc(struct parser *parser, char character) {
+    skip_space(parser);
+    if (parser->next >= parser->end || *parser->next != character) {
+        return fail(parser, "Expected '%c'", character);
+    }
+    parser->next++;
+    return OK;
+}
+
+static enum status parse_string_rc(struct parser *parser) {
+    enum status status = expect_rc(parser, '"');
+    if (status != OK) {
+        return status;
+    }
+    while (parser->next < parser->end && *parser->next != '"') {
+        parser->next++;
+    }
+    return expect_rc(parser, '"');
+}
+
+static enum status parse_number_rc(struct parser *parser, double *sum) {
+    double number;
+    const char *end = scan_number(parser->next, parser->end, &number);
+    if (end == NULL) {
+        return fail(parser, "Invalid number", 0);
+    }
+    parser->next = end;
+    *sum += number;
+    return OK;
+}
+
+static enum status parse_literal_rc(struct parser *parser,
+    const char *literal, size_t length) {
+    if ((size_t) (parser->end - parser->next) < length
+        || memcmp(parser->next, literal, length) != 0) {
+        return fail(parser, "Invalid literal", 0);
+    }
+    parser->next += length;
+    return OK;
+}
+
+static enum status parse_array_rc(struct parser *parser, int depth,
+    double *sum) {
+    enum status status = expect_rc(parser, '[');
+    if (status != OK) {
+        return status;
+    }
+    do {
+        status = parse_value_rc(parser, depth + 1, sum);
+        if (status != OK) {
+            return status;
+        }
+        skip_space(parser);
+    } while (parser->next < parser->end && *parser->next == ','
+        && parser->next++);
+    return expect_rc(parser, ']');
+}
+
+static enum status parse_object_rc(struct parser *parser, int depth,
+    double *sum) {
+    enum status status = expect_rc(parser, '{');
+    if (status != OK) {
+        return status;
+    }
+    do {
+        status = parse_string_rc(parser);
+        if (status != OK) {
+            return status;
+        }
+        status = expect_rc(parser, ':');
+        if (status != OK) {
+            return status;
+        }
+        status = parse_value_rc(parser, depth + 1, sum);
+        if (status != OK) {
+            return status;
+        }
+        skip_space(parser);
+    } while (parser->next < parser->end && *parser->next == ','
+        && parser->next++);
+    return expect_rc(parser, '}');
+}
+
+static enum status parse_value_rc(struct parser *parser, int depth,
+    double *sum) {
+    if (depth > MAX_DEPTH) {
+        return fail(parser, "Too deep: %d", depth);
+    }
+    skip_space(parser);
+    if (parser->next >= parser->end) {
+        return fail(parser, "Unexpected end of document", 0);
+    }
+    switch (*parser->next) {
+    case '{':
+        return parse_object_rc(parser, depth, sum);
+    case '[':
+        return parse_array_rc(parser, depth, sum);
+    case '"':
+        return parse_string_rc(parser);
+    case 't':
+        return parse_literal_rc(parser, "true", 4);
+    case 'n':
+        return parse_literal_rc(parser, "null", 4);
+    default:
+        return parse_number_rc(parser, sum);
+    }
+}
+
+static double parse_with_error_codes(const struct corpus *corpus,
+    long *errors) {
+    double sum = 0;
+    long failed = 0;
+    for (int index = 0; index < DOCUMENTS; index++) {
+        struct parser parser = {
+            corpus->text + corpus->document[index],
+            corpus->text + corpus->document[index + 1]
+        };
+        double value = 0;
+        enum status status = parse_value_rc(&parser, 0, &value);
+        if (status == OK) {
+            skip_space(&parser);
+            if (parser.next != parser.end) {
+                status = fail(&parser, "Trailing characters", 0);
+            }
+        }
+        if (status == OK) {
+            sum += value;
+        } else {
+            failed++;
+        }
+    }
+    *errors = failed;
+    return sum;
+}
+
+static double measure(double (*parse)(const struct corpus *, long *),
+    const struct corpus *corpus, long *errors, double *checksum) {
+    clock_t start = clock();
+    for (int round = 0; round < ROUNDS; round++) {
+        *checksum = parse(corpus, errors);
+    }
+    return (double) corpus->length * ROUNDS / 1e6
+        / ((double) (clock() - start) / CLOCKS_PER_SEC);
+}
+
+/**
+ * Compares an exception-based parser with an error-code-based parser, at
+ * several ratios of malformed documents.
+ */
+int main(void) {
+    static const double ratios[] = {0, 0.001, 0.01, 0.1, 0.5};
+    static struct corpus corpus;
+    char *original;
+
+    generate_corpus(&corpus);
+    original = malloc(corpus.length);
+    memcpy(original, corpus.text, corpus.length);
+    printf("Corpus: %d documents, %.1f MB\n", DOCUMENTS, corpus.length / 1e6);
+    printf("%-10s %14s %14s %10s\n", "malformed", "THROW (MB/s)",
+        "codes (MB/s)", "errors");
+
+    for (size_t index = 0; index < sizeof(ratios) / sizeof(*ratios); index++) {
+        long exception_errors, code_errors;
+        double exception_sum, code_sum, exception_speed, code_speed;
+        corrupt_corpus(&corpus, original, ratios[index]);
+        exception_speed = measure(parse_with_exceptions, &corpus,
+            &exception_errors, &exception_sum);
+        code_speed = measure(parse_with_error_codes, &corpus,
+            &code_errors, &code_sum);
+        printf("%9.1f%% %14.1f %14.1f %10ld\n", ratios[index] * 100,
+            exception_speed, code_speed, exception_errors);
+        if (exception_errors != code_errors || exception_sum != code_sum) {
+            printf("Parsers disagree: %ld/%ld errors, %g/%g sum\n",
+                exception_errors, code_errors, exception_sum, code_sum);
+            return EXIT_FAILURE;
+        }
+    }
+
+    free(original);
+    free(corpus.text);
+    return EXIT_SUCCESS;
+}
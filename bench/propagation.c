@@ -0,0 +1,75 @@
+/*
+ * Copyright 2025 Guillermo Calvo
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <time.h>
+
+#define DEPTH 32
+
+/* one more block catches the exception at the deepest nesting */
+#define EXCEPTIONS4C_MAX_BLOCKS (DEPTH + 1)
+#include <exceptions4c-lite.h>
+
+struct e4c_context exceptions4c = {0};
+const e4c_exception_type OOPS = "Oops";
+const e4c_exception_type OTHER = "Other";
+
+#define ITERATIONS 200000
+
+static void nest_try(int depth) {
+    if (depth == 0) {
+        THROW(OOPS, NULL);
+    }
+    TRY {
+        nest_try(depth - 1);
+    } CATCH (OTHER) {
+        abort();
+    }
+}
+
+static void nest_try_catching(int depth) {
+    if (depth == 0) {
+        THROW(OOPS, NULL);
+    }
+    TRY_CATCHING(OTHER) {
+        nest_try_catching(depth - 1);
+    } CATCH (OTHER) {
+        abort();
+    }
+}
+
+static double measure(void (*nest)(int), int depth) {
+    clock_t start = clock();
+    for (int iteration = 0; iteration < ITERATIONS; iteration++) {
+        TRY {
+            nest(depth);
+        } CATCH (OOPS) {
+            /* expected */
+        }
+    }
+    return (double) (clock() - start) * 1e9 / CLOCKS_PER_SEC / ITERATIONS;
+}
+
+/**
+ * Measures the cost of propagating an exception through nested blocks.
+ */
+int main(void) {
+    printf("%-8s %16s %16s\n", "depth", "TRY (ns)", "TRY_CATCHING (ns)");
+    for (int depth = 1; depth <= DEPTH; depth *= 2) {
+        printf("%-8d %16.1f %16.1f\n", depth,
+            measure(nest_try, depth), measure(nest_try_catching, depth));
+    }
+    return EXIT_SUCCESS;
+}
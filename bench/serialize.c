@@ -0,0 +1,89 @@
+/*
+ * Copyright 2025 Guillermo Calvo
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <time.h>
+#include <exceptions4c-lite-serialize.h>
+
+struct e4c_context exceptions4c = {0};
+const e4c_exception_type JOB_FAILED = "Job failed";
+
+#define RECORDS 1000000
+
+static _Alignas(8) unsigned char buffer[EXCEPTIONS4C_RECORD_SIZE];
+static struct e4c_record_slot slot;
+static int channel[2];
+static volatile size_t checksum;
+
+static void encode(void) {
+    long job = 42;
+    for (long index = 0; index < RECORDS; index++) {
+        checksum += ENCODE_EXCEPTION(buffer, sizeof(buffer), &job, sizeof(job));
+    }
+}
+
+static void decode(void) {
+    struct e4c_record_view record;
+    for (long index = 0; index < RECORDS; index++) {
+        checksum += DECODE_EXCEPTION(&record, buffer, sizeof(buffer));
+    }
+}
+
+static void through_pipe(void) {
+    struct e4c_record_view record;
+    long job = 42;
+    for (long index = 0; index < RECORDS; index++) {
+        size_t size;
+        (void) SEND_EXCEPTION(channel[1], &job, sizeof(job));
+        size = RECEIVE_EXCEPTION(channel[0], buffer, sizeof(buffer));
+        checksum += DECODE_EXCEPTION(&record, buffer, size);
+    }
+}
+
+static void through_slot(void) {
+    struct e4c_record_view record;
+    long job = 42;
+    for (long index = 0; index < RECORDS; index++) {
+        (void) PUBLISH_EXCEPTION(&slot, &job, sizeof(job));
+        checksum += DECODE_SLOT(&record, &slot);
+        atomic_store_explicit(&slot.size, 0, memory_order_release);
+    }
+}
+
+static void measure(const char *name, void (*function)(void)) {
+    clock_t start = clock();
+    function();
+    printf("%-20s %12.0f records/s\n", name,
+        RECORDS / ((double) (clock() - start) / CLOCKS_PER_SEC));
+}
+
+/**
+ * Measures how many exceptions per second can be encoded, decoded, and sent
+ * through a pipe or a slot of shared memory.
+ */
+int main(void) {
+    if (pipe(channel) != 0) {
+        return EXIT_FAILURE;
+    }
+    TRY {
+        THROWF(JOB_FAILED, "Job %d failed: %s", 42, "connection reset by peer");
+    } CATCH (JOB_FAILED) {
+        measure("ENCODE_EXCEPTION", encode);
+        measure("DECODE_EXCEPTION", decode);
+        measure("pipe", through_pipe);
+        measure("shared memory slot", through_slot);
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,101 @@
+/*
+ * Copyright 2025 Guillermo Calvo
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <time.h>
+#include <exceptions4c-lite.h>
+
+struct e4c_context exceptions4c = {0};
+const e4c_exception_type NOT_A_NUMBER = "Not a number";
+
+#define LENGTH 4096
+#define ROUNDS 20000
+
+struct job {
+    const double *values;
+    size_t length;
+    double total;
+};
+
+static double values[LENGTH];
+
+static double sum_without_try(const double *data, size_t length) {
+    double total = 0;
+    for (size_t index = 0; index < length; index++) {
+        if (data[index] != data[index]) {
+            return 0;
+        }
+        total += data[index];
+    }
+    return total;
+}
+
+static double sum_volatile(const double *data, size_t length) {
+    volatile double total = 0; /* NOSONAR */
+    TRY {
+        for (size_t index = 0; index < length; index++) {
+            if (data[index] != data[index]) {
+                THROW(NOT_A_NUMBER, NULL);
+            }
+            total += data[index];
+        }
+    } CATCH (NOT_A_NUMBER) {
+        total = 0;
+    }
+    return total;
+}
+
+static void sum(void *argument) {
+    struct job *job = argument;
+    double total = 0;
+    for (size_t index = 0; index < job->length; index++) {
+        if (job->values[index] != job->values[index]) {
+            THROW(NOT_A_NUMBER, NULL);
+        }
+        total += job->values[index];
+    }
+    job->total = total;
+}
+
+static double sum_try_call(const double *data, size_t length) {
+    struct job job = {data, length, 0};
+    TRY_CALL(sum, &job) CATCH (NOT_A_NUMBER) {
+        job.total = 0;
+    }
+    return job.total;
+}
+
+static double measure(double (*function)(const double *, size_t), double *checksum) {
+    clock_t start = clock();
+    for (int round = 0; round < ROUNDS; round++) {
+        *checksum += function(values, LENGTH);
+    }
+    return (double) (clock() - start) * 1e9 / CLOCKS_PER_SEC / ((double) ROUNDS * LENGTH);
+}
+
+/**
+ * Compares a loop-carried accumulator inside TRY (volatile) and TRY_CALL.
+ */
+int main(void) {
+    double checksum = 0;
+    for (size_t index = 0; index < LENGTH; index++) {
+        values[index] = (double) (index % 97) / 7.0;
+    }
+    printf("%-20s %10.3f ns/element\n", "no TRY", measure(sum_without_try, &checksum));
+    printf("%-20s %10.3f ns/element\n", "TRY + volatile", measure(sum_volatile, &checksum));
+    printf("%-20s %10.3f ns/element\n", "TRY_CALL", measure(sum_try_call, &checksum));
+    printf("(checksum %g)\n", checksum);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,133 @@
+/*
+ * Copyright 2025 Guillermo Calvo
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "event-loop.h"
+
+struct e4c_context exceptions4c = {0};
+
+const e4c_exception_type PROTOCOL_ERROR = "Protocol error";
+
+#define CLIENTS 4
+
+struct session {
+  int peer;
+  int messages;
+  int errors;
+};
+
+static struct event_loop loop;
+
+/* Reads a message; messages starting with '!' are malformed */
+static void on_message(struct connection *connection) {
+  struct session *session = connection->data;
+  char buffer[64];
+  ssize_t length = read(connection->fd, buffer, sizeof(buffer) - 1);
+  if (length <= 0) {
+    THROWF(PROTOCOL_ERROR, "Connection %d closed", connection->fd);
+  }
+  buffer[length] = '\0';
+  if (buffer[0] == '!') {
+    THROWF(PROTOCOL_ERROR, "Malformed message: %s", buffer);
+  }
+  session->messages++;
+}
+
+/* Closes the connection that failed, leaving the others untouched */
+static void on_error(struct connection *connection,
+  const struct e4c_exception *exception) {
+  struct session *session = connection->data;
+  printf("fd %d: %s: %s\n", connection->fd, exception->name,
+    exception->message);
+  session->errors++;
+  event_loop_remove(&loop, connection);
+  (void) close(connection->fd);
+}
+
+# define FAIL \
+  ((void) fprintf(stderr, "Error: %s:%d\n", __FILE__, __LINE__), abort())
+
+int main(void) { /* NOSONAR */
+  struct connection connections[CLIENTS];
+  struct session sessions[CLIENTS] = {0};
+  int pair[2];
+
+  if (!event_loop_init(&loop, CLIENTS)) {
+    FAIL;
+  }
+
+  for (int index = 0; index < CLIENTS; index++) {
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, pair) != 0) {
+      FAIL;
+    }
+    sessions[index].peer = pair[1];
+    connections[index].fd = pair[0];
+    connections[index].on_event = on_message;
+    connections[index].on_error = on_error;
+    connections[index].data = &sessions[index];
+    (void) event_loop_add(&loop, &connections[index]);
+  }
+
+  // The second client sends a malformed message
+  for (int index = 0; index < CLIENTS; index++) {
+    const char *message = index == 1 ? "!garbage" : "hello";
+    if (write(sessions[index].peer, message, strlen(message)) < 0) {
+      FAIL;
+    }
+  }
+
+  if (event_loop_run_once(&loop, 1000) != 1) {
+    FAIL;
+  }
+
+  if (sessions[1].errors != 1 || sessions[1].messages != 0
+    || loop.connections != CLIENTS - 1) {
+    FAIL;
+  }
+
+  // The remaining clients keep working
+  for (int index = 0; index < CLIENTS; index++) {
+    if (index != 1 && write(sessions[index].peer, "again", 5) < 0) {
+      FAIL;
+    }
+  }
+
+  if (event_loop_run_once(&loop, 1000) != 0) {
+    FAIL;
+  }
+
+  for (int index = 0; index < CLIENTS; index++) {
+    if (index != 1 && (sessions[index].messages != 2
+      || sessions[index].errors != 0)) {
+      FAIL;
+    }
+    (void) close(sessions[index].peer);
+    if (index != 1) {
+      (void) close(connections[index].fd);
+    }
+  }
+
+  if (exceptions4c.blocks != 0) {
+    FAIL;
+  }
+
+  event_loop_free(&loop);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,140 @@
+/*
+ * Copyright 2025 Guillermo Calvo
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef EVENT_LOOP_H
+#define EVENT_LOOP_H
+
+#include <poll.h>
+#include <stdlib.h>
+#include <exceptions4c-lite.h>
+
+/*
+ * A minimal event loop that isolates its callbacks from each other.
+ *
+ * Instead of wrapping every callback in its own TRY block, the loop arms a
+ * single BATCH_TRY per iteration. When a callback throws, the exception is
+ * attributed to its connection, and the loop continues with the next ready
+ * connection. After the iteration, each exception is routed to the error
+ * handler of the connection that threw it.
+ */
+
+struct connection;
+
+typedef void (*event_handler)(struct connection *connection);
+
+typedef void (*error_handler)(struct connection *connection,
+  const struct e4c_exception *exception);
+
+struct connection {
+  int fd;
+  event_handler on_event;
+  error_handler on_error;
+  void *data;
+};
+
+struct event_loop {
+  size_t capacity;
+  size_t connections;
+  struct connection **connection;
+  struct connection **ready;
+  struct pollfd *poll;
+  struct e4c_batch_failure *failure;
+};
+
+/* Allocates an event loop that can watch up to `capacity` connections */
+static inline int event_loop_init(struct event_loop *loop, size_t capacity) {
+  loop->capacity = capacity;
+  loop->connections = 0;
+  loop->connection = calloc(capacity, sizeof(*loop->connection));
+  loop->ready = calloc(capacity, sizeof(*loop->ready));
+  loop->poll = calloc(capacity, sizeof(*loop->poll));
+  loop->failure = calloc(capacity, sizeof(*loop->failure));
+  return loop->connection && loop->ready && loop->poll && loop->failure;
+}
+
+/* Releases the memory allocated by an event loop */
+static inline void event_loop_free(struct event_loop *loop) {
+  free(loop->connection);
+  free(loop->ready);
+  free(loop->poll);
+  free(loop->failure);
+}
+
+/* Starts watching a connection for incoming data */
+static inline int event_loop_add(struct event_loop *loop,
+  struct connection *connection) {
+  if (loop->connections >= loop->capacity) {
+    return 0;
+  }
+  loop->connection[loop->connections++] = connection;
+  return 1;
+}
+
+/* Stops watching a connection */
+static inline void event_loop_remove(struct event_loop *loop,
+  const struct connection *connection) {
+  for (size_t index = 0; index < loop->connections; index++) {
+    if (loop->connection[index] == connection) {
+      loop->connection[index] = loop->connection[--loop->connections];
+      return;
+    }
+  }
+}
+
+/* Calls the handlers of the ready connections and returns how many failed */
+static inline size_t event_loop_dispatch(struct event_loop *loop,
+  struct connection *const *ready, size_t count) {
+  struct e4c_batch batch = {loop->failure, loop->capacity};
+  size_t index;
+
+  BATCH_TRY (index, count, &batch) {
+    ready[index]->on_event(ready[index]);
+  }
+
+  for (index = 0; index < batch.failed && index < batch.capacity; index++) {
+    struct connection *connection = ready[loop->failure[index].index];
+    connection->on_error(connection, &loop->failure[index].exception);
+  }
+
+  return batch.failed;
+}
+
+/* Waits for ready connections and dispatches them; returns -1 on error */
+static inline int event_loop_run_once(struct event_loop *loop, int timeout) {
+  size_t count = 0;
+  int events;
+
+  for (size_t index = 0; index < loop->connections; index++) {
+    loop->poll[index].fd = loop->connection[index]->fd;
+    loop->poll[index].events = POLLIN;
+    loop->poll[index].revents = 0;
+  }
+
+  events = poll(loop->poll, loop->connections, timeout);
+  if (events <= 0) {
+    return events;
+  }
+
+  for (size_t index = 0; index < loop->connections; index++) {
+    if (loop->poll[index].revents != 0) {
+      loop->ready[count++] = loop->connection[index];
+    }
+  }
+
+  return (int) event_loop_dispatch(loop, loop->ready, count);
+}
+
+#endif
@@ -0,0 +1,712 @@
+/*
+ * Copyright 2025 Guillermo Calvo
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Checked arithmetic for exceptions4c-lite.
+ *
+ * This companion header provides scalar operations that throw
+ * #ARITHMETIC_OVERFLOW instead of silently wrapping around, and array kernels
+ * that validate whole arrays without a branch per element. The kernels
+ * accumulate an error flag across all elements, so that the compiler MAY
+ * vectorize them, and only look for the first offending element when the
+ * flag is set. The kernel for 32-bit products is the exception: it branches
+ * per element unless the target has a widening vector multiply, since it
+ * would be slower otherwise.
+ *
+ * All you need to do is include it, and define the exception type once, in
+ * the main program.
+ *
+ * ```c
+ * #include <exceptions4c-lite-arithmetic.h>
+ *
+ * struct e4c_context exceptions4c = {0};
+ * const e4c_exception_type ARITHMETIC_OVERFLOW = "Arithmetic overflow";
+ * ```
+ *
+ * Scalar operations and array kernels MAY be mixed freely.
+ *
+ * ```c
+ * int32_t total = CHECKED_ADD(price, CHECKED_MUL(quantity, tax));
+ * CHECKED_ADD_ARRAY(balances, deposits, withdrawals, accounts);
+ * ```
+ *
+ * Array kernels accept <tt>long long</tt> elements even where it is not the
+ * same type as <tt>int64_t</tt>. Scalar operations don't: such operands MUST be
+ * cast to <tt>int64_t</tt>.
+ *
+ * @remark
+ * This header relies on the <tt>__builtin_*_overflow</tt> functions provided by
+ * GCC and Clang, and on C11 <tt>_Generic</tt> selections.
+ *
+ * @file        exceptions4c-lite-arithmetic.h
+ * @version     1.0.0
+ * @author      [Guillermo Calvo](https://guillermo.dev)
+ * @copyright   Licensed under [Apache 2.0]
+ * @see         For more information, visit the [project on GitHub]
+ *
+ * [Guillermo Calvo]: https://guillermo.dev
+ * [Apache 2.0]: http://www.apache.org/licenses/LICENSE-2.0
+ * [project on GitHub]: https://github.com/guillermocalvo/exceptions4c-lite
+ */
+
+#ifndef EXCEPTIONS4C_LITE_ARITHMETIC
+
+/**
+ * Returns the major version number of the checked arithmetic.
+ */
+#define EXCEPTIONS4C_LITE_ARITHMETIC 1
+
+#include <limits.h> /* LLONG_MAX */
+#include <stdint.h> /* int32_t, int64_t, INT*_MAX, INT*_MIN, uint*_t */
+#include <exceptions4c-lite.h>
+
+#if !defined(__GNUC__) && !defined(__clang__)
+#error "exceptions4c-lite-arithmetic.h requires __builtin_*_overflow"
+#endif
+
+/**
+ * Represents an arithmetic operation whose result cannot be represented.
+ *
+ * This exception type is thrown when an integer operation overflows, when an
+ * integer is divided by zero, or when a floating-point operation yields an
+ * infinite or NaN result.
+ *
+ * You MUST define this exception type for your program.
+ *
+ * ```c
+ * const e4c_exception_type ARITHMETIC_OVERFLOW = "Arithmetic overflow";
+ * ```
+ *
+ * @see CHECKED_ADD
+ * @see CHECKED_ADD_ARRAY
+ */
+extern const e4c_exception_type ARITHMETIC_OVERFLOW;
+
+/**
+ * @internal
+ * @brief Throws an #ARITHMETIC_OVERFLOW for an integer operation.
+ */
+static EXCEPTIONS4C_COLD EXCEPTIONS4C_NORETURN
+void e4c_overflow(long long a, char operation, long long b,
+    const char *file, int line) {
+    if (operation == '/' && b == 0) {
+        e4c_throwf(ARITHMETIC_OVERFLOW, "ARITHMETIC_OVERFLOW", file, line,
+            "Division by zero: %lld / 0", a);
+    }
+    e4c_throwf(ARITHMETIC_OVERFLOW, "ARITHMETIC_OVERFLOW", file, line,
+        "Integer overflow: %lld %c %lld", a, operation, b);
+}
+
+/**
+ * @internal
+ * @brief Throws an #ARITHMETIC_OVERFLOW for an element of an integer array.
+ */
+static EXCEPTIONS4C_COLD EXCEPTIONS4C_NORETURN
+void e4c_overflow_at(size_t index, long long a, char operation, long long b,
+    const char *file, int line) {
+    e4c_throwf(ARITHMETIC_OVERFLOW, "ARITHMETIC_OVERFLOW", file, line,
+        "Integer overflow at index %lu: %lld %c %lld",
+        (unsigned long) index, a, operation, b);
+}
+
+/**
+ * @internal
+ * @brief Throws an #ARITHMETIC_OVERFLOW for an element of a float array.
+ */
+static EXCEPTIONS4C_COLD EXCEPTIONS4C_NORETURN
+void e4c_not_finite_at(size_t index, double a, char operation, double b,
+    const char *file, int line) {
+    e4c_throwf(ARITHMETIC_OVERFLOW, "ARITHMETIC_OVERFLOW", file, line,
+        "Non-finite result at index %lu: %g %c %g",
+        (unsigned long) index, a, operation, b);
+}
+
+/**
+ * @internal
+ * @brief Adds two 32-bit integers.
+ */
+static inline int32_t e4c_add_int32(int32_t a, int32_t b,
+    const char *file, int line) {
+    int32_t result;
+    if (EXCEPTIONS4C_UNLIKELY(__builtin_add_overflow(a, b, &result))) {
+        e4c_overflow(a, '+', b, file, line);
+    }
+    return result;
+}
+
+/**
+ * @internal
+ * @brief Adds two 64-bit integers.
+ */
+static inline int64_t e4c_add_int64(int64_t a, int64_t b,
+    const char *file, int line) {
+    int64_t result;
+    if (EXCEPTIONS4C_UNLIKELY(__builtin_add_overflow(a, b, &result))) {
+        e4c_overflow(a, '+', b, file, line);
+    }
+    return result;
+}
+
+/**
+ * @internal
+ * @brief Subtracts two 32-bit integers.
+ */
+static inline int32_t e4c_sub_int32(int32_t a, int32_t b,
+    const char *file, int line) {
+    int32_t result;
+    if (EXCEPTIONS4C_UNLIKELY(__builtin_sub_overflow(a, b, &result))) {
+        e4c_overflow(a, '-', b, file, line);
+    }
+    return result;
+}
+
+/**
+ * @internal
+ * @brief Subtracts two 64-bit integers.
+ */
+static inline int64_t e4c_sub_int64(int64_t a, int64_t b,
+    const char *file, int line) {
+    int64_t result;
+    if (EXCEPTIONS4C_UNLIKELY(__builtin_sub_overflow(a, b, &result))) {
+        e4c_overflow(a, '-', b, file, line);
+    }
+    return result;
+}
+
+/**
+ * @internal
+ * @brief Multiplies two 32-bit integers.
+ */
+static inline int32_t e4c_mul_int32(int32_t a, int32_t b,
+    const char *file, int line) {
+    int32_t result;
+    if (EXCEPTIONS4C_UNLIKELY(__builtin_mul_overflow(a, b, &result))) {
+        e4c_overflow(a, '*', b, file, line);
+    }
+    return result;
+}
+
+/**
+ * @internal
+ * @brief Multiplies two 64-bit integers.
+ */
+static inline int64_t e4c_mul_int64(int64_t a, int64_t b,
+    const char *file, int line) {
+    int64_t result;
+    if (EXCEPTIONS4C_UNLIKELY(__builtin_mul_overflow(a, b, &result))) {
+        e4c_overflow(a, '*', b, file, line);
+    }
+    return result;
+}
+
+/**
+ * @internal
+ * @brief Divides two 32-bit integers.
+ */
+static inline int32_t e4c_div_int32(int32_t a, int32_t b,
+    const char *file, int line) {
+    if (EXCEPTIONS4C_UNLIKELY(b == 0 || (a == INT32_MIN && b == -1))) {
+        e4c_overflow(a, '/', b, file, line);
+    }
+    return a / b;
+}
+
+/**
+ * @internal
+ * @brief Divides two 64-bit integers.
+ */
+static inline int64_t e4c_div_int64(int64_t a, int64_t b,
+    const char *file, int line) {
+    if (EXCEPTIONS4C_UNLIKELY(b == 0 || (a == INT64_MIN && b == -1))) {
+        e4c_overflow(a, '/', b, file, line);
+    }
+    return a / b;
+}
+
+/**
+ * Adds two integers, throwing an #ARITHMETIC_OVERFLOW if the result cannot be
+ * represented.
+ *
+ * The operation is selected by the type of <tt>a + b</tt>, which MUST be
+ * either <tt>int32_t</tt> or <tt>int64_t</tt>.
+ *
+ * @param a The first operand.
+ * @param b The second operand.
+ * @return The sum of <tt>a</tt> and <tt>b</tt>.
+ *
+ * @see CHECKED_ADD_ARRAY
+ */
+#define CHECKED_ADD(a, b)                                                   \
+                                                                            \
+  _Generic((a) + (b),                                                       \
+    int32_t: e4c_add_int32,                                                 \
+    int64_t: e4c_add_int64)((a), (b), EXCEPTION_SITE)
+
+/**
+ * Subtracts two integers, throwing an #ARITHMETIC_OVERFLOW if the result
+ * cannot be represented.
+ *
+ * The operation is selected by the type of <tt>a - b</tt>, which MUST be
+ * either <tt>int32_t</tt> or <tt>int64_t</tt>.
+ *
+ * @param a The first operand.
+ * @param b The second operand.
+ * @return The difference between <tt>a</tt> and <tt>b</tt>.
+ */
+#define CHECKED_SUB(a, b)                                                   \
+                                                                            \
+  _Generic((a) - (b),                                                       \
+    int32_t: e4c_sub_int32,                                                 \
+    int64_t: e4c_sub_int64)((a), (b), EXCEPTION_SITE)
+
+/**
+ * Multiplies two integers, throwing an #ARITHMETIC_OVERFLOW if the result
+ * cannot be represented.
+ *
+ * The operation is selected by the type of <tt>a * b</tt>, which MUST be
+ * either <tt>int32_t</tt> or <tt>int64_t</tt>.
+ *
+ * @param a The first operand.
+ * @param b The second operand.
+ * @return The product of <tt>a</tt> and <tt>b</tt>.
+ *
+ * @see CHECKED_MUL_ARRAY
+ */
+#define CHECKED_MUL(a, b)                                                   \
+                                                                            \
+  _Generic((a) * (b),                                                       \
+    int32_t: e4c_mul_int32,                                                 \
+    int64_t: e4c_mul_int64)((a), (b), EXCEPTION_SITE)
+
+/**
+ * Divides two integers, throwing an #ARITHMETIC_OVERFLOW if <tt>b</tt> is zero
+ * or the result cannot be represented.
+ *
+ * The operation is selected by the type of <tt>a / b</tt>, which MUST be
+ * either <tt>int32_t</tt> or <tt>int64_t</tt>.
+ *
+ * @param a The dividend.
+ * @param b The divisor.
+ * @return The quotient of <tt>a</tt> and <tt>b</tt>, truncated toward zero.
+ */
+#define CHECKED_DIV(a, b)                                                   \
+                                                                            \
+  _Generic((a) / (b),                                                       \
+    int32_t: e4c_div_int32,                                                 \
+    int64_t: e4c_div_int64)((a), (b), EXCEPTION_SITE)
+
+/**
+ * @internal
+ * @brief Adds two arrays of 32-bit integers.
+ */
+static inline void e4c_add_array_int32(int32_t *restrict result,
+    const int32_t *restrict a, const int32_t *restrict b, size_t count,
+    const char *file, int line) {
+    uint32_t overflow = 0;
+    size_t index;
+    for (index = 0; index < count; index++) {
+        uint32_t sum = (uint32_t) a[index] + (uint32_t) b[index];
+        /* the sign of the sum differs from the signs of both operands */
+        overflow |= (sum ^ (uint32_t) a[index]) & (sum ^ (uint32_t) b[index]);
+        result[index] = (int32_t) sum;
+    }
+    if (EXCEPTIONS4C_UNLIKELY(overflow >> 31)) {
+        int32_t sum;
+        for (index = 0; !__builtin_add_overflow(a[index], b[index], &sum);
+            index++) {
+            /* find the first sum that cannot be represented */
+        }
+        e4c_overflow_at(index, a[index], '+', b[index], file, line);
+    }
+}
+
+/**
+ * @internal
+ * @brief Adds two arrays of 64-bit integers.
+ */
+static inline void e4c_add_array_int64(int64_t *restrict result,
+    const int64_t *restrict a, const int64_t *restrict b, size_t count,
+    const char *file, int line) {
+    uint64_t overflow = 0;
+    size_t index;
+    for (index = 0; index < count; index++) {
+        uint64_t sum = (uint64_t) a[index] + (uint64_t) b[index];
+        /* the sign of the sum differs from the signs of both operands */
+        overflow |= (sum ^ (uint64_t) a[index]) & (sum ^ (uint64_t) b[index]);
+        result[index] = (int64_t) sum;
+    }
+    if (EXCEPTIONS4C_UNLIKELY(overflow >> 63)) {
+        int64_t sum;
+        for (index = 0; !__builtin_add_overflow(a[index], b[index], &sum);
+            index++) {
+            /* find the first sum that cannot be represented */
+        }
+        e4c_overflow_at(index, a[index], '+', b[index], file, line);
+    }
+}
+
+/**
+ * @internal
+ * @brief Adds two arrays of floats.
+ */
+static inline void e4c_add_array_float(float *restrict result,
+    const float *restrict a, const float *restrict b, size_t count,
+    const char *file, int line) {
+    int overflow = 0;
+    size_t index;
+    for (index = 0; index < count; index++) {
+        float sum = a[index] + b[index];
+        /* the difference is NaN unless the sum is finite */
+        overflow |= sum - sum != 0;
+        result[index] = sum;
+    }
+    if (EXCEPTIONS4C_UNLIKELY(overflow)) {
+        for (index = 0; result[index] - result[index] == 0; index++) {
+            /* find the first non-finite sum */
+        }
+        e4c_not_finite_at(index, a[index], '+', b[index], file, line);
+    }
+}
+
+/**
+ * @internal
+ * @brief Adds two arrays of <tt>long long</tt> integers.
+ */
+static inline void e4c_add_array_llong(long long *restrict result,
+    const long long *restrict a, const long long *restrict b, size_t count,
+    const char *file, int line) {
+    unsigned long long overflow = 0;
+    size_t index;
+    for (index = 0; index < count; index++) {
+        unsigned long long sum = (unsigned long long) a[index]
+            + (unsigned long long) b[index];
+        /* the sign of the sum differs from the signs of both operands */
+        overflow |= (sum ^ (unsigned long long) a[index])
+            & (sum ^ (unsigned long long) b[index]);
+        result[index] = (long long) sum;
+    }
+    if (EXCEPTIONS4C_UNLIKELY(overflow > LLONG_MAX)) {
+        long long sum;
+        for (index = 0; !__builtin_add_overflow(a[index], b[index], &sum);
+            index++) {
+            /* find the first sum that cannot be represented */
+        }
+        e4c_overflow_at(index, a[index], '+', b[index], file, line);
+    }
+}
+
+/**
+ * @internal
+ * @brief Throws an #ARITHMETIC_OVERFLOW for the first product of two arrays
+ * of 32-bit integers that cannot be represented.
+ */
+static EXCEPTIONS4C_COLD EXCEPTIONS4C_NORETURN
+void e4c_mul_overflow_int32(const int32_t *a, const int32_t *b,
+    const char *file, int line) {
+    int32_t product;
+    size_t index;
+    for (index = 0; !__builtin_mul_overflow(a[index], b[index], &product);
+        index++) {
+        /* find the first product that cannot be represented */
+    }
+    e4c_overflow_at(index, a[index], '*', b[index], file, line);
+}
+
+/**
+ * @internal
+ * @brief Multiplies two arrays of 32-bit integers.
+ *
+ * The branch-free kernel is only used when the target can multiply vectors
+ * of 32-bit integers into 64-bit products. Otherwise, computing every product
+ * in 64 bits is about twice as slow as checking each product and branching.
+ */
+static inline void e4c_mul_array_int32(int32_t *restrict result,
+    const int32_t *restrict a, const int32_t *restrict b, size_t count,
+    const char *file, int line) {
+    size_t index;
+#if defined(__SSE4_1__) || defined(__AVX2__) || defined(__ARM_NEON)
+    uint64_t overflow = 0;
+    for (index = 0; index < count; index++) {
+        int64_t product = (int64_t) a[index] * b[index];
+        /* the upper half is nonzero unless the product fits in 32 bits */
+        overflow |= ((uint64_t) product + 0x80000000U) >> 32;
+        result[index] = (int32_t) (uint32_t) product;
+    }
+    if (EXCEPTIONS4C_UNLIKELY(overflow)) {
+        e4c_mul_overflow_int32(a, b, file, line);
+    }
+#else
+    for (index = 0; index < count; index++) {
+        if (EXCEPTIONS4C_UNLIKELY(__builtin_mul_overflow(a[index], b[index],
+            &result[index]))) {
+            e4c_mul_overflow_int32(a, b, file, line);
+        }
+    }
+#endif
+}
+
+/**
+ * @internal
+ * @brief Multiplies two arrays of 64-bit integers.
+ *
+ * No common target multiplies vectors of 64-bit integers with an overflow
+ * check, so this kernel is not vectorized, and it is slightly slower than
+ * checking each product and branching.
+ */
+static inline void e4c_mul_array_int64(int64_t *restrict result,
+    const int64_t *restrict a, const int64_t *restrict b, size_t count,
+    const char *file, int line) {
+    int overflow = 0;
+    size_t index;
+    for (index = 0; index < count; index++) {
+        overflow |= __builtin_mul_overflow(a[index], b[index], &result[index]);
+    }
+    if (EXCEPTIONS4C_UNLIKELY(overflow)) {
+        int64_t product;
+        for (index = 0; !__builtin_mul_overflow(a[index], b[index], &product);
+            index++) {
+            /* find the first product that cannot be represented */
+        }
+        e4c_overflow_at(index, a[index], '*', b[index], file, line);
+    }
+}
+
+/**
+ * @internal
+ * @brief Multiplies two arrays of <tt>long long</tt> integers.
+ */
+static inline void e4c_mul_array_llong(long long *restrict result,
+    const long long *restrict a, const long long *restrict b, size_t count,
+    const char *file, int line) {
+    int overflow = 0;
+    size_t index;
+    for (index = 0; index < count; index++) {
+        overflow |= __builtin_mul_overflow(a[index], b[index], &result[index]);
+    }
+    if (EXCEPTIONS4C_UNLIKELY(overflow)) {
+        long long product;
+        for (index = 0; !__builtin_mul_overflow(a[index], b[index], &product);
+            index++) {
+            /* find the first product that cannot be represented */
+        }
+        e4c_overflow_at(index, a[index], '*', b[index], file, line);
+    }
+}
+
+/**
+ * @internal
+ * @brief Multiplies two arrays of floats.
+ */
+static inline void e4c_mul_array_float(float *restrict result,
+    const float *restrict a, const float *restrict b, size_t count,
+    const char *file, int line) {
+    int overflow = 0;
+    size_t index;
+    for (index = 0; index < count; index++) {
+        float product = a[index] * b[index];
+        /* the difference is NaN unless the product is finite */
+        overflow |= product - product != 0;
+        result[index] = product;
+    }
+    if (EXCEPTIONS4C_UNLIKELY(overflow)) {
+        for (index = 0; result[index] - result[index] == 0; index++) {
+            /* find the first non-finite product */
+        }
+        e4c_not_finite_at(index, a[index], '*', b[index], file, line);
+    }
+}
+
+/**
+ * @internal
+ * @brief Sums an array of 32-bit integers.
+ */
+static inline int32_t e4c_sum_int32(const int32_t *array, size_t count,
+    const char *file, int line) {
+    int64_t sum = 0;
+    size_t index;
+    for (index = 0; index < count; index++) {
+        sum += array[index];
+    }
+    if (EXCEPTIONS4C_UNLIKELY(sum < INT32_MIN || sum > INT32_MAX)) {
+        for (sum = 0, index = 0; sum >= INT32_MIN && sum <= INT32_MAX;
+            sum += array[index++]) {
+            /* find the first partial sum that cannot be represented */
+        }
+        e4c_overflow_at(index - 1, sum - array[index - 1], '+',
+            array[index - 1], file, line);
+    }
+    return (int32_t) sum;
+}
+
+/**
+ * @internal
+ * @brief Sums an array of 64-bit integers.
+ */
+static inline int64_t e4c_sum_int64(const int64_t *array, size_t count,
+    const char *file, int line) {
+    int64_t sum = 0;
+    int64_t carry = 0;
+    size_t index;
+    for (index = 0; index < count; index++) {
+        /* counts the wraparounds, which cancel out if the sum fits */
+        carry += __builtin_add_overflow(sum, array[index], &sum)
+            * (array[index] < 0 ? -1 : 1);
+    }
+    if (EXCEPTIONS4C_UNLIKELY(carry != 0)) {
+        int64_t next;
+        for (sum = 0, index = 0; !__builtin_add_overflow(sum, array[index],
+            &next); sum = next, index++) {
+            /* find the first partial sum that cannot be represented */
+        }
+        e4c_overflow_at(index, sum, '+', array[index], file, line);
+    }
+    return sum;
+}
+
+/**
+ * @internal
+ * @brief Sums an array of <tt>long long</tt> integers.
+ */
+static inline long long e4c_sum_llong(const long long *array, size_t count,
+    const char *file, int line) {
+    long long sum = 0;
+    long long carry = 0;
+    size_t index;
+    for (index = 0; index < count; index++) {
+        /* counts the wraparounds, which cancel out if the sum fits */
+        carry += __builtin_add_overflow(sum, array[index], &sum)
+            * (array[index] < 0 ? -1 : 1);
+    }
+    if (EXCEPTIONS4C_UNLIKELY(carry != 0)) {
+        long long next;
+        for (sum = 0, index = 0; !__builtin_add_overflow(sum, array[index],
+            &next); sum = next, index++) {
+            /* find the first partial sum that cannot be represented */
+        }
+        e4c_overflow_at(index, sum, '+', array[index], file, line);
+    }
+    return sum;
+}
+
+/**
+ * @internal
+ * @brief Sums an array of floats.
+ */
+static inline float e4c_sum_float(const float *array, size_t count,
+    const char *file, int line) {
+    float sum = 0;
+    size_t index;
+    for (index = 0; index < count; index++) {
+        sum += array[index];
+    }
+    if (EXCEPTIONS4C_UNLIKELY(sum - sum != 0)) {
+        for (sum = 0, index = 0; sum - sum == 0; sum += array[index++]) {
+            /* find the first partial sum that is not finite */
+        }
+        e4c_not_finite_at(index - 1, sum - array[index - 1], '+',
+            array[index - 1], file, line);
+    }
+    return sum;
+}
+
+/**
+ * Adds two arrays element by element, throwing an #ARITHMETIC_OVERFLOW if any
+ * of the sums cannot be represented.
+ *
+ * The kernel is selected by the type of the elements of <tt>result</tt>, which
+ * MUST be <tt>int32_t</tt>, <tt>int64_t</tt>, <tt>long long</tt>, or
+ * <tt>float</tt>. Integer sums MUST NOT overflow, and float sums MUST be
+ * finite.
+ *
+ * The check doesn't branch per element. If it fails, the arrays are scanned
+ * again to report the first offending index in the message of the exception.
+ *
+ * @attention
+ * <tt>result</tt> MUST NOT overlap <tt>a</tt> or <tt>b</tt>. If an exception is
+ * thrown, the contents of <tt>result</tt> are unspecified.
+ *
+ * @param result The array that receives the sums.
+ * @param a The first array of operands.
+ * @param b The second array of operands.
+ * @param count The number of elements of each array.
+ *
+ * @see CHECKED_ADD
+ */
+#define CHECKED_ADD_ARRAY(result, a, b, count)                              \
+                                                                            \
+  _Generic(*(result),                                                       \
+    int32_t: e4c_add_array_int32,                                           \
+    int64_t: e4c_add_array_int64,                                           \
+    float: e4c_add_array_float,                                             \
+    default: e4c_add_array_llong)(                                          \
+      (result), (a), (b), (count), EXCEPTION_SITE)
+
+/**
+ * Multiplies two arrays element by element, throwing an #ARITHMETIC_OVERFLOW if
+ * any of the products cannot be represented.
+ *
+ * This macro works just like #CHECKED_ADD_ARRAY, but it multiplies the
+ * elements instead of adding them. 32-bit products are computed in 64 bits and
+ * range-checked without branching only if the target has a widening vector
+ * multiply (SSE4.1, AVX2 or NEON). Otherwise, each product is checked, and the
+ * exception is thrown as soon as one of them overflows.
+ *
+ * @attention
+ * <tt>result</tt> MUST NOT overlap <tt>a</tt> or <tt>b</tt>. If an exception is
+ * thrown, the contents of <tt>result</tt> are unspecified.
+ *
+ * @param result The array that receives the products.
+ * @param a The first array of operands.
+ * @param b The second array of operands.
+ * @param count The number of elements of each array.
+ *
+ * @see CHECKED_MUL
+ */
+#define CHECKED_MUL_ARRAY(result, a, b, count)                              \
+                                                                            \
+  _Generic(*(result),                                                       \
+    int32_t: e4c_mul_array_int32,                                           \
+    int64_t: e4c_mul_array_int64,                                           \
+    float: e4c_mul_array_float,                                             \
+    default: e4c_mul_array_llong)(                                          \
+      (result), (a), (b), (count), EXCEPTION_SITE)
+
+/**
+ * Sums the elements of an array, throwing an #ARITHMETIC_OVERFLOW if the sum
+ * cannot be represented.
+ *
+ * The kernel is selected by the type of the elements of <tt>array</tt>, which
+ * MUST be <tt>int32_t</tt>, <tt>int64_t</tt>, <tt>long long</tt>, or
+ * <tt>float</tt>. Integer partial sums MAY overflow, as long as the total sum
+ * fits. Float sums MUST be finite.
+ *
+ * The check doesn't branch per element. If it fails, the array is summed again
+ * to report the first partial sum that overflowed in the message of the
+ * exception.
+ *
+ * @param array The array to sum.
+ * @param count The number of elements of the array.
+ * @return The sum of all elements.
+ */
+#define CHECKED_SUM(array, count)                                           \
+                                                                            \
+  _Generic(*(array),                                                        \
+    int32_t: e4c_sum_int32,                                                 \
+    int64_t: e4c_sum_int64,                                                 \
+    float: e4c_sum_float,                                                   \
+    default: e4c_sum_llong)((array), (count), EXCEPTION_SITE)
+
+#endif
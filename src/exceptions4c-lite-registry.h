@@ -0,0 +1,325 @@
+/*
+ * Copyright 2025 Guillermo Calvo
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Runtime registry of exception types for exceptions4c-lite.
+ *
+ * Exception types are compared by pointer, so the same logical type defined in
+ * two shared objects never matches. This companion header interns types by
+ * name into a lock-free hash table, so that every module that interns the
+ * same name gets the same canonical type, and #CATCH keeps comparing a single
+ * pointer.
+ *
+ * All you need to do is include it, and define a global variable
+ * `exceptions4c_registry` once, in the main program.
+ *
+ * ```c
+ * #include <exceptions4c-lite-registry.h>
+ *
+ * struct e4c_context exceptions4c = {0};
+ * struct e4c_registry exceptions4c_registry = {0};
+ * ```
+ *
+ * Plugins SHOULD intern their types when they are loaded, and release them
+ * when they are unloaded.
+ *
+ * ```c
+ * e4c_exception_type PLUGIN_ERROR;
+ *
+ * void plugin_load(void) {
+ *   PLUGIN_ERROR = INTERN_TYPE("Plugin error");
+ * }
+ *
+ * void plugin_unload(void) {
+ *   RELEASE_TYPE(PLUGIN_ERROR);
+ * }
+ * ```
+ *
+ * @file        exceptions4c-lite-registry.h
+ * @version     1.0.0
+ * @author      [Guillermo Calvo](https://guillermo.dev)
+ * @copyright   Licensed under [Apache 2.0]
+ * @see         For more information, visit the [project on GitHub]
+ *
+ * [Guillermo Calvo]: https://guillermo.dev
+ * [Apache 2.0]: http://www.apache.org/licenses/LICENSE-2.0
+ * [project on GitHub]: https://github.com/guillermocalvo/exceptions4c-lite
+ */
+
+#ifndef EXCEPTIONS4C_LITE_REGISTRY
+
+/**
+ * Returns the major version number of the registry.
+ */
+#define EXCEPTIONS4C_LITE_REGISTRY 1
+
+#include <stdatomic.h> /* atomic_*, memory_order_* */
+#include <stddef.h> /* offsetof */
+#include <stdint.h> /* uintptr_t */
+#include <exceptions4c-lite.h>
+
+#ifndef EXCEPTIONS4C_REGISTRY_SIZE
+
+/**
+ * Determines the maximum number of exception types that can be registered.
+ *
+ * It MUST be a power of two. The table of types is preallocated inside the
+ * [global variable](#exceptions4c_registry).
+ *
+ * @note
+ * You MAY define this macro with a different value.
+ */
+#define EXCEPTIONS4C_REGISTRY_SIZE 256
+
+#endif
+
+#ifndef EXCEPTIONS4C_REGISTRY_NAME_LENGTH
+
+/**
+ * Determines the maximum length (in bytes) of the name of a registered type,
+ * including the terminating null character.
+ *
+ * Names are stored inline in the table of types.
+ *
+ * @note
+ * You MAY define this macro with a different value.
+ */
+#define EXCEPTIONS4C_REGISTRY_NAME_LENGTH 64
+
+#endif
+
+/**
+ * @internal
+ * @brief The slot of the registry is empty.
+ */
+#define EXCEPTION_SLOT_EMPTY 0
+
+/**
+ * @internal
+ * @brief The slot of the registry is being written by another thread.
+ */
+#define EXCEPTION_SLOT_WRITING 1
+
+/**
+ * @internal
+ * @brief The slot of the registry holds a registered type.
+ */
+#define EXCEPTION_SLOT_READY 2
+
+/**
+ * @internal
+ * @brief Represents the registered exception types.
+ */
+struct e4c_registry {
+    atomic_uint types;
+    struct e4c_registered_type {
+        atomic_uint state;
+        atomic_uint references;
+        unsigned id;
+        char name[EXCEPTIONS4C_REGISTRY_NAME_LENGTH];
+    } slot[EXCEPTIONS4C_REGISTRY_SIZE];
+};
+
+/**
+ * Contains the registered exception types.
+ *
+ * You MUST define this global variable once for your program, and it MUST be
+ * visible to every module that uses the registry (for example, by linking the
+ * main program with <tt>-rdynamic</tt>).
+ *
+ * ```c
+ * struct e4c_registry exceptions4c_registry = {0};
+ * ```
+ */
+extern struct e4c_registry exceptions4c_registry;
+
+/**
+ * @internal
+ * @brief Returns the slot of a registered type, or <tt>NULL</tt>.
+ */
+static inline struct e4c_registered_type *e4c_registry_slot(
+    e4c_exception_type type) {
+    uintptr_t address = (uintptr_t) type;
+    uintptr_t first = (uintptr_t) &exceptions4c_registry.slot[0];
+    uintptr_t last = (uintptr_t)
+        &exceptions4c_registry.slot[EXCEPTIONS4C_REGISTRY_SIZE - 1];
+    if (type == NULL || address < first || address > last) {
+        return NULL;
+    }
+    return (struct e4c_registered_type *)
+        (address - offsetof(struct e4c_registered_type, name));
+}
+
+/**
+ * @internal
+ * @brief Interns an exception type by name.
+ */
+static inline e4c_exception_type e4c_intern(const char *name) {
+    unsigned long hash = 2166136261UL;
+    size_t length = 0;
+    size_t probe;
+    while (name[length] != '\0') {
+        hash = (hash ^ (unsigned char) name[length++]) * 16777619UL;
+    }
+    if (length >= EXCEPTIONS4C_REGISTRY_NAME_LENGTH) {
+        return NULL;
+    }
+    for (probe = 0; probe < EXCEPTIONS4C_REGISTRY_SIZE; probe++) {
+        struct e4c_registered_type *slot = &exceptions4c_registry.slot[
+            (hash + probe) & (EXCEPTIONS4C_REGISTRY_SIZE - 1)];
+        unsigned state = atomic_load_explicit(&slot->state,
+            memory_order_acquire);
+        size_t index;
+        if (state == EXCEPTION_SLOT_EMPTY
+            && atomic_compare_exchange_strong_explicit(&slot->state, &state,
+                EXCEPTION_SLOT_WRITING, memory_order_acq_rel,
+                memory_order_acquire)) {
+            for (index = 0; index <= length; index++) {
+                slot->name[index] = name[index];
+            }
+            slot->id = atomic_fetch_add_explicit(&exceptions4c_registry.types,
+                1, memory_order_relaxed) + 1;
+            atomic_store_explicit(&slot->references, 1, memory_order_relaxed);
+            atomic_store_explicit(&slot->state, EXCEPTION_SLOT_READY,
+                memory_order_release);
+            return slot->name;
+        }
+        while (state == EXCEPTION_SLOT_WRITING) {
+            state = atomic_load_explicit(&slot->state, memory_order_acquire);
+        }
+        for (index = 0; index <= length && slot->name[index] == name[index];
+            index++) {
+            /* compare the names */
+        }
+        if (index > length) {
+            atomic_fetch_add_explicit(&slot->references, 1,
+                memory_order_relaxed);
+            return slot->name;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Interns an exception type by name.
+ *
+ * Every module that interns the same name gets the same canonical type, so
+ * exceptions of this type thrown by one module MAY be caught by #CATCH blocks
+ * in any other module. The name is also the default message of the type.
+ *
+ * Each call adds a reference to the type, which SHOULD be released via
+ * #RELEASE_TYPE when it is no longer needed.
+ *
+ * This macro is lock-free for types that are already registered, and MAY be
+ * called concurrently from any thread.
+ *
+ * @param name The name of the exception type.
+ * @return The canonical exception type; or <tt>NULL</tt> if the name is too
+ *   long or the registry is full.
+ *
+ * @see EXCEPTIONS4C_REGISTRY_SIZE
+ * @see RELEASE_TYPE
+ * @see TYPE_ID
+ */
+#define INTERN_TYPE(name)                                                   \
+                                                                            \
+  e4c_intern(name)
+
+/**
+ * @internal
+ * @brief Releases a reference to a registered exception type, unless it has
+ * none left.
+ */
+static inline void e4c_release(e4c_exception_type type) {
+    struct e4c_registered_type *slot = e4c_registry_slot(type);
+    unsigned references;
+    if (slot == NULL) {
+        return;
+    }
+    references = atomic_load_explicit(&slot->references, memory_order_relaxed);
+    while (references > 0 && !atomic_compare_exchange_weak_explicit(
+        &slot->references, &references, references - 1,
+        memory_order_relaxed, memory_order_relaxed)) {
+        /* try again with the current number of references */
+    }
+}
+
+/**
+ * Releases a reference to an exception type returned by #INTERN_TYPE.
+ *
+ * Released types keep their name and ID in the registry, so exceptions that
+ * still refer to them remain valid, and interning the same name again yields
+ * the same type. Releasing a type that has no references left does nothing.
+ *
+ * @param type The exception type to release.
+ *
+ * @see INTERN_TYPE
+ * @see TYPE_REFERENCES
+ */
+#define RELEASE_TYPE(type)                                                  \
+                                                                            \
+  e4c_release(type)
+
+/**
+ * @internal
+ * @brief Returns the dense ID of a registered exception type.
+ */
+static inline unsigned e4c_type_id(e4c_exception_type type) {
+    const struct e4c_registered_type *slot = e4c_registry_slot(type);
+    return slot != NULL ? slot->id : 0;
+}
+
+/**
+ * Returns the dense ID of an exception type returned by #INTERN_TYPE.
+ *
+ * IDs are assigned consecutively, starting from one, in the order in which
+ * types are first registered. They MAY be used to index arrays, such as
+ * per-type statistics.
+ *
+ * @param type The exception type.
+ * @return The ID of the type; or zero if it is not registered.
+ *
+ * @see INTERN_TYPE
+ */
+#define TYPE_ID(type)                                                       \
+                                                                            \
+  e4c_type_id(type)
+
+/**
+ * @internal
+ * @brief Returns the number of references to a registered exception type.
+ */
+static inline unsigned e4c_type_references(e4c_exception_type type) {
+    struct e4c_registered_type *slot = e4c_registry_slot(type);
+    return slot != NULL
+        ? atomic_load_explicit(&slot->references, memory_order_relaxed) : 0;
+}
+
+/**
+ * Returns the number of references to an exception type returned by
+ * #INTERN_TYPE that have not been released.
+ *
+ * @param type The exception type.
+ * @return The number of references to the type; or zero if it is not
+ *   registered.
+ *
+ * @see RELEASE_TYPE
+ */
+#define TYPE_REFERENCES(type)                                               \
+                                                                            \
+  e4c_type_references(type)
+
+#endif
@@ -0,0 +1,639 @@
+/*
+ * Copyright 2025 Guillermo Calvo
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Serialization of exceptions for exceptions4c-lite.
+ *
+ * Exceptions cannot propagate across process boundaries, so a worker process
+ * that fails can only report why through some kind of channel. This companion
+ * header encodes the current #EXCEPTION into a compact, versioned binary
+ * record that MAY be sent through a pipe or published into a slot of shared
+ * memory, and then decoded and thrown again by another process.
+ *
+ * Records carry the exception type as a string, so that the receiving side
+ * resolves it to one of its own types, instead of trusting a pointer from a
+ * different address space.
+ *
+ * ```c
+ * #include <exceptions4c-lite-serialize.h>
+ *
+ * struct e4c_context exceptions4c = {0};
+ * ```
+ *
+ * Workers SHOULD send the exception from a #CATCH_ALL block.
+ *
+ * ```c
+ * TRY {
+ *   process(job);
+ * } CATCH_ALL {
+ *   SEND_EXCEPTION(channel, &job.id, sizeof(job.id));
+ * }
+ * ```
+ *
+ * The parent receives the record and throws it again.
+ *
+ * ```c
+ * unsigned char buffer[EXCEPTIONS4C_RECORD_SIZE];
+ * struct e4c_record_view record;
+ * size_t size = RECEIVE_EXCEPTION(channel, buffer, sizeof(buffer));
+ * if (size > 0 && DECODE_EXCEPTION(&record, buffer, size)) {
+ *   THROW_RECORD(RESOLVE_TYPE(&record, known_types), &record);
+ * }
+ * ```
+ *
+ * @remark
+ * This header relies on POSIX <tt>read</tt> and <tt>write</tt>, and on C11
+ * atomics for slots of shared memory.
+ *
+ * @file        exceptions4c-lite-serialize.h
+ * @version     1.0.0
+ * @author      [Guillermo Calvo](https://guillermo.dev)
+ * @copyright   Licensed under [Apache 2.0]
+ * @see         For more information, visit the [project on GitHub]
+ *
+ * [Guillermo Calvo]: https://guillermo.dev
+ * [Apache 2.0]: http://www.apache.org/licenses/LICENSE-2.0
+ * [project on GitHub]: https://github.com/guillermocalvo/exceptions4c-lite
+ */
+
+#ifndef EXCEPTIONS4C_LITE_SERIALIZE
+
+/**
+ * Returns the major version number of the serialization.
+ */
+#define EXCEPTIONS4C_LITE_SERIALIZE 1
+
+#include <errno.h> /* errno, EINTR, EMSGSIZE, EBADMSG */
+#include <stdatomic.h> /* atomic_*, memory_order_* */
+#include <stdio.h> /* snprintf */
+#include <string.h> /* strcmp, strlen, memcpy */
+#include <unistd.h> /* read, write, ssize_t */
+#include <exceptions4c-lite.h>
+
+#ifndef EXCEPTIONS4C_RECORD_SIZE
+
+/**
+ * Determines the maximum size (in bytes) of an encoded exception, including
+ * its payload.
+ *
+ * It is the size of the buffer used by #SEND_EXCEPTION and of the slots of
+ * shared memory. As long as it does not exceed <tt>PIPE_BUF</tt>, records are
+ * written to pipes atomically, so that many workers MAY share the same pipe.
+ *
+ * @note
+ * You MAY define this macro with a different value.
+ */
+#define EXCEPTIONS4C_RECORD_SIZE 1024
+
+#endif
+
+/**
+ * @internal
+ * @brief The version of the record format.
+ *
+ * Decoders reject records of any other version.
+ */
+#define EXCEPTION_RECORD_VERSION 1
+
+/**
+ * @internal
+ * @brief The size of the fixed header of a record.
+ *
+ * All integers are unsigned and little-endian:
+ *
+ * | Offset | Size | Field                                    |
+ * | ------ | ---- | ---------------------------------------- |
+ * | 0      | 3    | Magic number <tt>"E4C"</tt>              |
+ * | 3      | 1    | Version of the record format             |
+ * | 4      | 4    | Total size of the record                 |
+ * | 8      | 4    | Line number                              |
+ * | 12     | 2    | Length of the type                       |
+ * | 14     | 2    | Length of the name                       |
+ * | 16     | 2    | Length of the message                    |
+ * | 18     | 2    | Length of the file                       |
+ * | 20     | 4    | Size of the payload                      |
+ *
+ * The header is followed by the null-terminated type, name, message and file,
+ * and then by the payload, aligned to eight bytes.
+ */
+#define EXCEPTION_RECORD_HEADER 24
+
+/**
+ * @internal
+ * @brief The size of a slot of shared memory while a writer is filling it.
+ */
+#define EXCEPTION_RECORD_BUSY ((size_t) -1)
+
+/**
+ * @internal
+ * @brief Returns the offset of the payload of a record.
+ */
+#define EXCEPTION_RECORD_PAYLOAD(strings)                                   \
+                                                                            \
+  (((size_t) EXCEPTION_RECORD_HEADER + (strings) + 7) & ~(size_t) 7)
+
+/**
+ * Represents an exception decoded from a record.
+ *
+ * All strings and the payload point into the buffer that holds the record, so
+ * the buffer MUST outlive the view. Exceptions thrown from the view keep their
+ * own copy of the strings.
+ *
+ * @see DECODE_EXCEPTION
+ * @see THROW_RECORD
+ */
+struct e4c_record_view {
+    /** The exception type, as a string. */
+    const char *type;
+
+    /** The name of the exception type. */
+    const char *name;
+
+    /** The error message. */
+    const char *message;
+
+    /** The source file that threw the exception; or empty if unknown. */
+    const char *file;
+
+    /** The line number that threw the exception; or zero if unknown. */
+    int line;
+
+    /** The payload attached by the sender; or <tt>NULL</tt>. */
+    const void *payload;
+
+    /** The size of the payload, in bytes. */
+    size_t payload_size;
+
+    /** The total size of the record, in bytes. */
+    size_t size;
+};
+
+/**
+ * Represents a slot of shared memory that MAY hold one record.
+ *
+ * Slots SHOULD be mapped by the parent before forking. Many workers MAY
+ * publish into the same slot, but only the first one succeeds until the
+ * reader empties it.
+ *
+ * ```c
+ * struct e4c_record_slot *slot = mmap(NULL, sizeof(*slot),
+ *   PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+ * ```
+ *
+ * @see PUBLISH_EXCEPTION
+ * @see DECODE_SLOT
+ */
+struct e4c_record_slot {
+    /**
+     * The size of the published record; zero if the slot is empty; or
+     * <tt>(size_t) -1</tt> while a writer is filling it.
+     */
+    atomic_size_t size;
+
+    /** The published record. */
+    _Alignas(8) unsigned char record[EXCEPTIONS4C_RECORD_SIZE];
+};
+
+/**
+ * @internal
+ * @brief Writes an unsigned little-endian integer.
+ */
+static inline void e4c_wire_put(unsigned char *buffer, unsigned long value,
+    int bytes) {
+    int index;
+    for (index = 0; index < bytes; index++) {
+        buffer[index] = (unsigned char) (value >> (8 * index));
+    }
+}
+
+/**
+ * @internal
+ * @brief Reads an unsigned little-endian integer.
+ */
+static inline unsigned long e4c_wire_get(const unsigned char *buffer,
+    int bytes) {
+    unsigned long value = 0;
+    int index;
+    for (index = bytes - 1; index >= 0; index--) {
+        value = (value << 8) | buffer[index];
+    }
+    return value;
+}
+
+/**
+ * @internal
+ * @brief Writes a null-terminated string and returns the next position.
+ */
+static inline unsigned char *e4c_wire_string(unsigned char *buffer,
+    const char *string, size_t length) {
+    memcpy(buffer, string, length);
+    buffer[length] = '\0';
+    return buffer + length + 1;
+}
+
+/**
+ * @internal
+ * @brief Encodes the current exception.
+ */
+static inline size_t e4c_encode(void *buffer, size_t capacity,
+    const void *payload, size_t payload_size) {
+    unsigned char *data = buffer;
+    const char *type = EXCEPTION.type != NULL ? EXCEPTION.type : "";
+    const char *name = EXCEPTION.name != NULL ? EXCEPTION.name : "";
+#ifndef NDEBUG
+    const char *file = EXCEPTION.file != NULL ? EXCEPTION.file : "";
+    int line = EXCEPTION.line > 0 ? EXCEPTION.line : 0;
+#else
+    const char *file = "";
+    int line = 0;
+#endif
+    size_t type_length = strlen(type);
+    size_t name_length = strlen(name);
+    size_t message_length = strlen(EXCEPTION.message);
+    size_t file_length = strlen(file);
+    size_t offset = EXCEPTION_RECORD_PAYLOAD(type_length + name_length
+        + message_length + file_length + 4);
+    unsigned char *position = data + EXCEPTION_RECORD_HEADER;
+    if (type_length > 0xFFFF || name_length > 0xFFFF
+        || message_length > 0xFFFF || file_length > 0xFFFF
+        || payload_size > capacity || offset > capacity - payload_size
+        || offset + payload_size > 0xFFFFFFFFUL) {
+        return 0;
+    }
+    data[0] = 'E';
+    data[1] = '4';
+    data[2] = 'C';
+    data[3] = EXCEPTION_RECORD_VERSION;
+    e4c_wire_put(data + 4, (unsigned long) (offset + payload_size), 4);
+    e4c_wire_put(data + 8, (unsigned long) line, 4);
+    e4c_wire_put(data + 12, (unsigned long) type_length, 2);
+    e4c_wire_put(data + 14, (unsigned long) name_length, 2);
+    e4c_wire_put(data + 16, (unsigned long) message_length, 2);
+    e4c_wire_put(data + 18, (unsigned long) file_length, 2);
+    e4c_wire_put(data + 20, (unsigned long) payload_size, 4);
+    position = e4c_wire_string(position, type, type_length);
+    position = e4c_wire_string(position, name, name_length);
+    position = e4c_wire_string(position, EXCEPTION.message, message_length);
+    position = e4c_wire_string(position, file, file_length);
+    while (position < data + offset) {
+        *position++ = 0;
+    }
+    if (payload_size > 0) {
+        memcpy(data + offset, payload, payload_size);
+    }
+    return offset + payload_size;
+}
+
+/**
+ * Encodes the current exception into a record.
+ *
+ * The record contains the type, name, message and source location of
+ * #EXCEPTION, followed by an optional payload that is copied as it is.
+ *
+ * @param buffer The buffer where the record will be written.
+ * @param capacity The size of the buffer, in bytes.
+ * @param payload The payload to attach; or <tt>NULL</tt>.
+ * @param payload_size The size of the payload, in bytes.
+ * @return The size of the record; or zero if it doesn't fit in the buffer.
+ *
+ * @see DECODE_EXCEPTION
+ * @see SEND_EXCEPTION
+ */
+#define ENCODE_EXCEPTION(buffer, capacity, payload, payload_size)           \
+                                                                            \
+  e4c_encode((buffer), (capacity), (payload), (payload_size))
+
+/**
+ * @internal
+ * @brief Decodes a record without copying it.
+ */
+static inline int e4c_decode(struct e4c_record_view *record,
+    const void *buffer, size_t size) {
+    const unsigned char *data = buffer;
+    size_t total;
+    size_t length[4];
+    size_t offset = EXCEPTION_RECORD_HEADER;
+    const char *string[4];
+    int index;
+    if (size < EXCEPTION_RECORD_HEADER || data[0] != 'E' || data[1] != '4'
+        || data[2] != 'C' || data[3] != EXCEPTION_RECORD_VERSION) {
+        return 0;
+    }
+    total = e4c_wire_get(data + 4, 4);
+    if (total < EXCEPTION_RECORD_HEADER || total > size) {
+        return 0;
+    }
+    for (index = 0; index < 4; index++) {
+        length[index] = e4c_wire_get(data + 12 + 2 * index, 2);
+        if (length[index] >= total - offset
+            || data[offset + length[index]] != '\0') {
+            return 0;
+        }
+        string[index] = (const char *) data + offset;
+        offset += length[index] + 1;
+    }
+    record->payload_size = e4c_wire_get(data + 20, 4);
+    offset = EXCEPTION_RECORD_PAYLOAD(offset - EXCEPTION_RECORD_HEADER);
+    if (offset > total || total - offset != record->payload_size) {
+        return 0;
+    }
+    record->type = string[0];
+    record->name = string[1];
+    record->message = string[2];
+    record->file = string[3];
+    record->line = (int) (e4c_wire_get(data + 8, 4) & 0x7FFFFFFF);
+    record->payload = record->payload_size > 0 ? data + offset : NULL;
+    record->size = total;
+    return 1;
+}
+
+/**
+ * Decodes a record without copying it.
+ *
+ * The record is validated before filling in the view, so that truncated,
+ * corrupt or incompatible records are rejected.
+ *
+ * @param record The view to fill in.
+ * @param buffer The buffer that holds the record.
+ * @param size The number of valid bytes in the buffer.
+ * @return A nonzero value if the record was decoded; or zero otherwise.
+ *
+ * @see ENCODE_EXCEPTION
+ * @see THROW_RECORD
+ */
+#define DECODE_EXCEPTION(record, buffer, size)                              \
+                                                                            \
+  e4c_decode((record), (buffer), (size))
+
+/**
+ * @internal
+ * @brief Resolves the type of a decoded exception.
+ */
+static inline e4c_exception_type e4c_resolve_type(
+    const struct e4c_record_view *record, const e4c_exception_type *types) {
+    for (; *types != NULL; types++) {
+        if (strcmp(*types, record->type) == 0) {
+            return *types;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Resolves the type of a decoded exception to one of the given types.
+ *
+ * Types are matched by their string, which is also their default message. If
+ * the types are interned via the registry, then #INTERN_TYPE MAY be used
+ * instead.
+ *
+ * @param record The decoded exception.
+ * @param types A vector of known types, terminated by <tt>NULL</tt>.
+ * @return The matching type; or <tt>NULL</tt> if none matches.
+ *
+ * @see THROW_RECORD
+ */
+#define RESOLVE_TYPE(record, types)                                         \
+                                                                            \
+  e4c_resolve_type((record), (types))
+
+/**
+ * @internal
+ * @brief Throws a decoded exception.
+ *
+ * The name and the file are copied, so that the exception doesn't point into
+ * a buffer that may be gone or reused by the time it is caught.
+ */
+static EXCEPTIONS4C_COLD EXCEPTIONS4C_NORETURN
+void e4c_throw_record(e4c_exception_type type,
+    const struct e4c_record_view *record, const char *file, int line) {
+    static EXCEPTIONS4C_THREAD_LOCAL struct {
+        char name[EXCEPTIONS4C_MAX_LENGTH];
+        char file[EXCEPTIONS4C_MAX_LENGTH];
+    } copy;
+    (void) snprintf(copy.name, sizeof(copy.name), "%s", record->name);
+    if (record->file[0] != '\0') {
+        (void) snprintf(copy.file, sizeof(copy.file), "%s", record->file);
+        file = copy.file;
+        line = record->line;
+    }
+    e4c_throw(type, copy.name, record->message, file, line);
+}
+
+/**
+ * Throws a decoded exception.
+ *
+ * The thrown exception keeps the name, message and source location of the
+ * original exception. If the location is unknown, then the location of this
+ * macro is used. The strings are copied (and truncated to
+ * #EXCEPTIONS4C_MAX_LENGTH), so the exception MAY propagate beyond the buffer
+ * that holds the record.
+ *
+ * @important
+ * Control never returns to the #THROW_RECORD point.
+ *
+ * @param exception_type The type of the exception to throw.
+ * @param record The decoded exception.
+ *
+ * @see DECODE_EXCEPTION
+ * @see RESOLVE_TYPE
+ */
+#define THROW_RECORD(exception_type, record)                                \
+                                                                            \
+  e4c_throw_record((exception_type), (record), EXCEPTION_SITE)
+
+/**
+ * @internal
+ * @brief Sends the current exception through a file descriptor.
+ */
+static inline int e4c_send_record(int descriptor, const void *payload,
+    size_t payload_size) {
+    unsigned char buffer[EXCEPTIONS4C_RECORD_SIZE];
+    size_t size = e4c_encode(buffer, sizeof(buffer), payload, payload_size);
+    size_t written = 0;
+    while (written < size) {
+        ssize_t result = write(descriptor, buffer + written, size - written);
+        if (result < 0 && errno == EINTR) {
+            continue;
+        }
+        if (result <= 0) {
+            return 0;
+        }
+        written += (size_t) result;
+    }
+    return size > 0;
+}
+
+/**
+ * Sends the current exception through a pipe or any other file descriptor.
+ *
+ * @param descriptor The file descriptor to write to.
+ * @param payload The payload to attach; or <tt>NULL</tt>.
+ * @param payload_size The size of the payload, in bytes.
+ * @return A nonzero value if the record was sent; or zero if it doesn't fit in
+ *   #EXCEPTIONS4C_RECORD_SIZE or the descriptor failed.
+ *
+ * @see RECEIVE_EXCEPTION
+ */
+#define SEND_EXCEPTION(descriptor, payload, payload_size)                   \
+                                                                            \
+  e4c_send_record((descriptor), (payload), (payload_size))
+
+/**
+ * @internal
+ * @brief Reads exactly the given number of bytes.
+ */
+static inline int e4c_read_fully(int descriptor, unsigned char *buffer,
+    size_t size) {
+    size_t total = 0;
+    while (total < size) {
+        ssize_t result = read(descriptor, buffer + total, size - total);
+        if (result < 0 && errno == EINTR) {
+            continue;
+        }
+        if (result <= 0) {
+            return 0;
+        }
+        total += (size_t) result;
+    }
+    return 1;
+}
+
+/**
+ * @internal
+ * @brief Receives one record from a file descriptor.
+ *
+ * Records that don't fit in the buffer are read in chunks and discarded, so
+ * that the stream stays in sync.
+ */
+static inline size_t e4c_receive_record(int descriptor, void *buffer,
+    size_t capacity) {
+    unsigned char *data = buffer;
+    size_t size;
+    size_t remaining;
+    errno = 0;
+    if (capacity < EXCEPTION_RECORD_HEADER
+        || !e4c_read_fully(descriptor, data, EXCEPTION_RECORD_HEADER)) {
+        return 0;
+    }
+    size = e4c_wire_get(data + 4, 4);
+    if (size < EXCEPTION_RECORD_HEADER || data[0] != 'E' || data[1] != '4'
+        || data[2] != 'C' || data[3] != EXCEPTION_RECORD_VERSION) {
+        errno = EBADMSG;
+        return 0;
+    }
+    if (size <= capacity) {
+        return e4c_read_fully(descriptor, data + EXCEPTION_RECORD_HEADER,
+            size - EXCEPTION_RECORD_HEADER) ? size : 0;
+    }
+    for (remaining = size - EXCEPTION_RECORD_HEADER; remaining > 0;) {
+        size_t chunk = remaining < capacity ? remaining : capacity;
+        if (!e4c_read_fully(descriptor, data, chunk)) {
+            return 0;
+        }
+        remaining -= chunk;
+    }
+    errno = EMSGSIZE;
+    return 0;
+}
+
+/**
+ * Receives one record from a pipe or any other file descriptor.
+ *
+ * The record is read as it is; it SHOULD be decoded via #DECODE_EXCEPTION.
+ *
+ * When zero is returned, <tt>errno</tt> tells why:
+ *
+ * - Zero: end of file.
+ * - <tt>EMSGSIZE</tt>: the record doesn't fit in the buffer. It was read and
+ *   discarded, so the next record MAY still be received.
+ * - <tt>EBADMSG</tt>, or any error set by <tt>read</tt>: the stream is corrupt
+ *   or broken. A header with the wrong magic number, version, or size is
+ *   rejected before reading the rest of the record. The descriptor is left in
+ *   an unknown position, so it SHOULD NOT be used anymore.
+ *
+ * @param descriptor The file descriptor to read from.
+ * @param buffer The buffer where the record will be read.
+ * @param capacity The size of the buffer, in bytes.
+ * @return The size of the record; or zero if no record was received.
+ *
+ * @see SEND_EXCEPTION
+ */
+#define RECEIVE_EXCEPTION(descriptor, buffer, capacity)                     \
+                                                                            \
+  e4c_receive_record((descriptor), (buffer), (capacity))
+
+/**
+ * @internal
+ * @brief Publishes the current exception into a slot of shared memory.
+ */
+static inline int e4c_publish_record(struct e4c_record_slot *slot,
+    const void *payload, size_t payload_size) {
+    size_t size = 0;
+    if (!atomic_compare_exchange_strong_explicit(&slot->size, &size,
+        EXCEPTION_RECORD_BUSY, memory_order_acquire, memory_order_relaxed)) {
+        return 0;
+    }
+    size = e4c_encode(slot->record, sizeof(slot->record), payload,
+        payload_size);
+    atomic_store_explicit(&slot->size, size, memory_order_release);
+    return size > 0;
+}
+
+/**
+ * Publishes the current exception into a slot of shared memory.
+ *
+ * Each slot holds one record until the reader empties it by setting its size
+ * back to zero. Writers claim the slot atomically, so that only one of many
+ * concurrent writers publishes its record.
+ *
+ * @param slot The slot to publish into.
+ * @param payload The payload to attach; or <tt>NULL</tt>.
+ * @param payload_size The size of the payload, in bytes.
+ * @return A nonzero value if the record was published; or zero if the slot
+ *   was not empty or the record doesn't fit in it.
+ *
+ * @see DECODE_SLOT
+ */
+#define PUBLISH_EXCEPTION(slot, payload, payload_size)                      \
+                                                                            \
+  e4c_publish_record((slot), (payload), (payload_size))
+
+/**
+ * @internal
+ * @brief Decodes the record published into a slot of shared memory.
+ */
+static inline int e4c_decode_slot(struct e4c_record_view *record,
+    struct e4c_record_slot *slot) {
+    size_t size = atomic_load_explicit(&slot->size, memory_order_acquire);
+    return size > 0 && size != EXCEPTION_RECORD_BUSY
+        && e4c_decode(record, slot->record, size);
+}
+
+/**
+ * Decodes the record published into a slot of shared memory, without copying
+ * it.
+ *
+ * @param record The view to fill in.
+ * @param slot The slot to decode.
+ * @return A nonzero value if the slot holds a valid record; or zero otherwise.
+ *
+ * @see PUBLISH_EXCEPTION
+ */
+#define DECODE_SLOT(record, slot)                                           \
+                                                                            \
+  e4c_decode_slot((record), (slot))
+
+#endif
@@ -57,9 +57,9 @@
 #define EXCEPTIONS4C_LITE 1
 
 #include <setjmp.h> /* longjmp, setjmp */
-#include <stdio.h> /* fflush, fprintf, snprintf, sprintf, stderr */
-#include <stdlib.h> /* EXIT_FAILURE, abort, exit */
-
+#include <stdarg.h> /* va_end, va_list, va_start */
+#include <stdio.h> /* fflush, fprintf, snprintf, stderr, vsnprintf */
+#include <stdlib.h> /* EXIT_FAILURE, abort, exit, getenv, size_t, strto* */
 #ifndef EXCEPTIONS4C_MAX_BLOCKS
 
 /**
@@ -91,6 +91,431 @@
 
 #endif
 
+#ifndef EXCEPTIONS4C_ARENA_SIZE
+
+/**
+ * Determines the size of the scoped arena, in bytes.
+ *
+ * When greater than zero, a bump arena of this size is preallocated inside the
+ * [global variable](#exceptions4c) that contains the current status of
+ * exceptions, and #ARENA_ALLOC becomes available.
+ *
+ * @note
+ * You MAY define this macro with a different value to enable the scoped arena.
+ *
+ * @see ARENA_ALLOC
+ */
+#define EXCEPTIONS4C_ARENA_SIZE 0
+
+#endif
+
+#ifndef EXCEPTIONS4C_OUT_OF_LINE
+
+/**
+ * Determines whether the rare paths are moved out of line.
+ *
+ * Overflow panics, message formatting, termination and propagation are always
+ * performed by small helper functions. When nonzero, these helpers are hinted
+ * as <tt>noinline</tt> and <tt>cold</tt>, and #CATCH blocks are hinted as
+ * unlikely. This reduces the code generated for each #TRY and #THROW, at the
+ * cost of a function call when an exception is actually thrown. When zero,
+ * the compiler MAY inline them.
+ *
+ * @note
+ * You MAY define this macro with a different value.
+ */
+#define EXCEPTIONS4C_OUT_OF_LINE 0
+
+#endif
+
+#ifndef EXCEPTIONS4C_FLIGHT_RECORDER
+
+/**
+ * Determines the number of events kept by the flight recorder.
+ *
+ * When greater than zero, every exception thrown or caught is recorded into a
+ * ring of this size, preallocated inside the
+ * [global variable](#exceptions4c) that contains the current status of
+ * exceptions. The recorded events are printed before the program terminates
+ * or panics, on demand through #EXCEPTION_PRINT_HISTORY, and when the program
+ * aborts, once #EXCEPTION_PRINT_HISTORY_ON_ABORT has been invoked.
+ *
+ * @note
+ * You MAY define this macro with a different value to enable the flight
+ * recorder. A power of two is recommended.
+ *
+ * @see EXCEPTION_PRINT_HISTORY
+ * @see EXCEPTION_PRINT_HISTORY_ON_ABORT
+ */
+#define EXCEPTIONS4C_FLIGHT_RECORDER 0
+
+#endif
+
+#if EXCEPTIONS4C_FLIGHT_RECORDER > 0 && !defined(EXCEPTIONS4C_TIMESTAMP)
+
+#if (defined(__x86_64__) || defined(__i386__))                              \
+  && (defined(__GNUC__) || defined(__clang__))
+
+/**
+ * Returns the current timestamp of the flight recorder.
+ *
+ * @note
+ * You MAY define this macro with a different value.
+ */
+#define EXCEPTIONS4C_TIMESTAMP                                              \
+  ((unsigned long long) __builtin_ia32_rdtsc())
+
+#else
+
+#include <time.h> /* clock */
+
+/**
+ * Returns the current timestamp of the flight recorder.
+ *
+ * @note
+ * You MAY define this macro with a different value.
+ */
+#define EXCEPTIONS4C_TIMESTAMP                                              \
+  ((unsigned long long) clock())
+
+#endif
+
+#endif
+
+#if EXCEPTIONS4C_FLIGHT_RECORDER > 0
+
+#include <signal.h> /* SIGABRT, SIG_DFL, raise, signal */
+
+#endif
+
+#ifndef EXCEPTIONS4C_THREAD_LOCAL
+
+/**
+ * Determines the storage class of the [global variable](#exceptions4c) that
+ * contains the current status of exceptions.
+ *
+ * Multithreaded programs SHOULD define this macro as <tt>_Thread_local</tt>
+ * (or any equivalent compiler extension), so that each thread handles its own
+ * exceptions.
+ *
+ * @note
+ * You MAY define this macro with a different value.
+ */
+#define EXCEPTIONS4C_THREAD_LOCAL
+
+#endif
+
+#ifndef EXCEPTIONS4C_CANCELLATION
+
+/**
+ * Determines whether threads can be cancelled cooperatively.
+ *
+ * When nonzero, any thread MAY request another thread to be cancelled through
+ * #CANCEL. The cancelled thread will then #THROW a #CANCELLED exception the
+ * next time it reaches a #CHECKPOINT.
+ *
+ * This feature requires C11 atomics and a #EXCEPTIONS4C_THREAD_LOCAL
+ * [global variable](#exceptions4c).
+ *
+ * @note
+ * You MAY define this macro with a different value to enable cancellation.
+ *
+ * @see CHECKPOINT
+ */
+#define EXCEPTIONS4C_CANCELLATION 0
+
+#endif
+
+#ifndef EXCEPTIONS4C_DEADLINES
+
+/**
+ * Determines whether #TRY blocks can be bound by a deadline.
+ *
+ * When nonzero, #TRY_WITHIN introduces blocks whose body MUST complete within
+ * a budget of time. The current thread will #THROW a #TIMEOUT exception the
+ * next time it reaches a #CHECKPOINT after the deadline has passed.
+ *
+ * @note
+ * You MAY define this macro with a different value to enable deadlines.
+ *
+ * @see TRY_WITHIN
+ */
+#define EXCEPTIONS4C_DEADLINES 0
+
+#endif
+
+#ifdef EXCEPTIONS4C_DEADLINE_SIGNAL
+
+#include <signal.h> /* sigaction, sigaddset, sigemptyset, sigprocmask */
+#include <stdatomic.h> /* atomic_signal_fence, memory_order_seq_cst */
+#include <sys/time.h> /* itimerval, setitimer */
+
+#else
+
+/**
+ * Determines the signal that checks for expired deadlines periodically.
+ *
+ * When nonzero (e.g. <tt>SIGALRM</tt>), #DEADLINE_TIMER installs a handler for
+ * this signal that throws a #TIMEOUT exception when the deadline of the
+ * current #TRY_WITHIN block has passed, even if its body doesn't reach any
+ * #CHECKPOINT.
+ *
+ * @attention
+ * The exception is thrown from the signal handler. The body of the
+ * #TRY_WITHIN block MUST only call async-signal-safe functions and the
+ * program SHOULD be single-threaded. If the signal arrives while a block is
+ * being entered, left, or propagated through, the exception is deferred to
+ * the next signal.
+ *
+ * @note
+ * You MAY define this macro with a different value to enable the timer signal.
+ *
+ * @see DEADLINE_TIMER
+ */
+#define EXCEPTIONS4C_DEADLINE_SIGNAL 0
+
+#endif
+
+#if EXCEPTIONS4C_DEADLINES && !defined(EXCEPTIONS4C_CLOCK)
+
+#include <time.h> /* clock_gettime, timespec */
+
+#ifdef CLOCK_MONOTONIC_COARSE
+
+/**
+ * Returns the current time of a monotonic clock, in milliseconds.
+ *
+ * @note
+ * You MAY define this macro with a different value.
+ */
+#define EXCEPTIONS4C_CLOCK e4c_clock(CLOCK_MONOTONIC_COARSE)
+
+#else
+
+/**
+ * Returns the current time of a monotonic clock, in milliseconds.
+ *
+ * @note
+ * You MAY define this macro with a different value.
+ */
+#define EXCEPTIONS4C_CLOCK e4c_clock(CLOCK_MONOTONIC)
+
+#endif
+
+/**
+ * @internal
+ * @brief Returns the current time of the given clock, in milliseconds.
+ */
+static inline unsigned long long e4c_clock(clockid_t clock) {
+    struct timespec now;
+    (void) clock_gettime(clock, &now);
+    return (unsigned long long) now.tv_sec * 1000ULL
+        + (unsigned long long) now.tv_nsec / 1000000ULL;
+}
+
+#endif
+
+#ifndef EXCEPTIONS4C_FAULT_INJECTION
+
+/**
+ * Determines whether exceptions can be injected at fault points.
+ *
+ * When nonzero, #FAULT_INJECTED MAY make chosen throw sites fire on demand,
+ * with a configured probability or every Nth call, so that error paths can be
+ * load-tested. Faults are configured through #INJECT_FAULTS, and no fault is
+ * injected until then.
+ *
+ * When zero, #FAULT_INJECTED evaluates to a falsy constant and fault points
+ * have no cost at all.
+ *
+ * @note
+ * You MAY define this macro with a different value to enable fault injection.
+ *
+ * @see FAULT_INJECTED
+ * @see INJECT_FAULTS
+ */
+#define EXCEPTIONS4C_FAULT_INJECTION 0
+
+#endif
+
+#ifndef EXCEPTIONS4C_RETRY
+
+/**
+ * Determines whether #RETRY blocks are available.
+ *
+ * When nonzero, #RETRY introduces blocks that are attempted again when they
+ * throw transient exceptions, and every exception records the number of
+ * attempts made by the last #RETRY block it propagated through.
+ *
+ * @note
+ * You MAY define this macro with a different value to enable retries.
+ *
+ * @see RETRY
+ */
+#define EXCEPTIONS4C_RETRY 0
+
+#endif
+
+#if EXCEPTIONS4C_RETRY && !defined(EXCEPTIONS4C_SLEEP)
+
+#include <time.h> /* nanosleep, timespec */
+
+/**
+ * Suspends the current thread for the given number of milliseconds.
+ *
+ * #RETRY blocks use this macro to back off between attempts.
+ *
+ * @note
+ * You MAY define this macro with a different value.
+ */
+#define EXCEPTIONS4C_SLEEP(milliseconds) e4c_sleep(milliseconds)
+
+/**
+ * @internal
+ * @brief Suspends the current thread for the given number of milliseconds.
+ */
+static inline void e4c_sleep(unsigned long milliseconds) {
+    struct timespec delay;
+    delay.tv_sec = (time_t) (milliseconds / 1000);
+    delay.tv_nsec = (long) (milliseconds % 1000) * 1000000L;
+    (void) nanosleep(&delay, NULL);
+}
+
+#endif
+
+#ifndef EXCEPTIONS4C_LOCKS
+
+/**
+ * Determines the maximum number of locks held at once by #LOCKED blocks.
+ *
+ * When greater than zero, #LOCKED, #READ_LOCKED and #WRITE_LOCKED introduce
+ * blocks that hold a POSIX mutex or read-write lock, and release it when an
+ * exception propagates out of them. Held locks are tracked in a stack
+ * preallocated inside the [global variable](#exceptions4c) that contains the
+ * current status of exceptions, so these blocks don't need a <tt>setjmp</tt>
+ * of their own.
+ *
+ * Multithreaded programs MUST define #EXCEPTIONS4C_THREAD_LOCAL too, so that
+ * each thread tracks its own locks.
+ *
+ * @note
+ * You MAY define this macro with a different value to enable lock blocks.
+ *
+ * @see LOCKED
+ */
+#define EXCEPTIONS4C_LOCKS 0
+
+#endif
+
+#ifndef EXCEPTIONS4C_LOCK_STATS
+
+/**
+ * Determines the number of #LOCKED blocks whose contention is measured.
+ *
+ * When greater than zero, each #LOCKED block records how long it waited for
+ * its lock, how long it held it, and how many times it was released because
+ * an exception propagated out of it. Measurements are kept per thread and per
+ * block, in histograms preallocated inside the
+ * [global variable](#exceptions4c) that contains the current status of
+ * exceptions. Blocks beyond this number are not measured.
+ *
+ * @note
+ * You MAY define this macro with a different value to enable lock statistics.
+ * It MUST be a power of two.
+ *
+ * @see LOCK_STATS
+ * @see EXCEPTION_PRINT_LOCK_STATS
+ */
+#define EXCEPTIONS4C_LOCK_STATS 0
+
+#endif
+
+#ifndef EXCEPTIONS4C_LIVE_STATS
+
+/**
+ * Determines the number of throw sites whose live statistics are published by
+ * each thread.
+ *
+ * When greater than zero, #LIVE_STATS_OPEN creates a segment of shared memory
+ * where the threads attached via #LIVE_STATS_ATTACH publish how many
+ * exceptions they throw, catch and terminate with, per type and per throw
+ * site, along with their current and maximum number of nested blocks. Other
+ * processes, such as the bundled <tt>exceptions4c-top</tt> viewer, MAY read
+ * these statistics while the program is running. Publishing them only writes
+ * to memory: it never blocks, nor makes system calls.
+ *
+ * Exceptions thrown from sites beyond this number are counted, but not
+ * published per site.
+ *
+ * @note
+ * You MAY define this macro with a different value to enable live statistics.
+ * It MUST be a power of two.
+ *
+ * @see LIVE_STATS_OPEN
+ */
+#define EXCEPTIONS4C_LIVE_STATS 0
+
+#endif
+
+#ifndef EXCEPTIONS4C_LIVE_THREADS
+
+/**
+ * Determines the maximum number of threads that publish live statistics.
+ *
+ * @note
+ * You MAY define this macro with a different value.
+ *
+ * @see LIVE_STATS_ATTACH
+ */
+#define EXCEPTIONS4C_LIVE_THREADS 16
+
+#endif
+
+#if EXCEPTIONS4C_LOCKS > 0
+#include <pthread.h> /* pthread_mutex_*, pthread_rwlock_* */
+#endif
+
+#if EXCEPTIONS4C_LIVE_STATS > 0
+#include <fcntl.h> /* O_CREAT, O_RDONLY, O_RDWR, O_TRUNC */
+#include <stdatomic.h> /* atomic_*, memory_order_* */
+#include <string.h> /* memcpy, memset, strlen */
+#include <sys/mman.h> /* mmap, munmap, shm_open, shm_unlink */
+#include <sys/stat.h> /* fstat */
+#include <unistd.h> /* close, ftruncate, getpid */
+#endif
+
+#if EXCEPTIONS4C_LOCKS > 0 && EXCEPTIONS4C_LOCK_STATS > 0                   \
+  && !defined(EXCEPTIONS4C_LOCK_CLOCK)
+
+#include <time.h> /* clock_gettime, timespec */
+
+/**
+ * Returns the current time of a monotonic clock, in nanoseconds.
+ *
+ * Lock statistics use this macro to measure wait and hold times.
+ *
+ * @note
+ * You MAY define this macro with a different value.
+ */
+#define EXCEPTIONS4C_LOCK_CLOCK e4c_nanoseconds()
+
+/**
+ * @internal
+ * @brief Returns the current time of a monotonic clock, in nanoseconds.
+ */
+static inline unsigned long long e4c_nanoseconds(void) {
+    struct timespec now;
+    (void) clock_gettime(CLOCK_MONOTONIC, &now);
+    return (unsigned long long) now.tv_sec * 1000000000ULL
+        + (unsigned long long) now.tv_nsec;
+}
+
+#endif
+
+#if EXCEPTIONS4C_CANCELLATION
+#include <stdatomic.h> /* atomic_int, atomic_load_explicit, atomic_store_explicit */
+#endif
+
 #ifndef EXCEPTIONS4C_PANIC
 
 #ifndef NDEBUG
@@ -99,11 +524,13 @@
  * Determines what needs to be done in the event of too many nested TRY blocks.
  *
  * @note
- * You MAY define this macro with a different value.
+ * You MAY define this macro with a different value. <tt>file</tt> and
+ * <tt>line</tt> hold the location of the offending #TRY block.
  */
 #define EXCEPTIONS4C_PANIC                                                  \
   (void) fprintf(stderr, "\n[exceptions4c-lite]: "                          \
-      "Too many TRY blocks nested.\n    at %s:%d\n", __FILE__, __LINE__),   \
+      "Too many TRY blocks nested.\n    at %s:%d\n", file, line),           \
+  (void) EXCEPTION_DUMP,                                                    \
   (void) fflush(stderr),                                                    \
   abort()
 
@@ -118,6 +545,7 @@
 #define EXCEPTIONS4C_PANIC                                                  \
   (void) fprintf(stderr, "\n[exceptions4c-lite]: "                          \
       "Too many TRY blocks nested.\n"),                                     \
+  (void) EXCEPTION_DUMP,                                                    \
   (void) fflush(stderr),                                                    \
   abort()
 
@@ -125,7 +553,6 @@
 
 #endif
 
-
 #ifndef EXCEPTIONS4C_TERMINATE
 
 /**
@@ -136,6 +563,7 @@
  */
 #define EXCEPTIONS4C_TERMINATE                                              \
   (void) EXCEPTION_PRINT,                                                   \
+  (void) EXCEPTION_DUMP,                                                    \
   (void) fflush(stderr),                                                    \
   exit(EXIT_FAILURE)
 
@@ -204,27 +632,460 @@ struct e4c_exception {
 
 #endif
 
+#if EXCEPTIONS4C_RETRY
+
+    /**
+     * The number of attempts made by the last #RETRY block this exception
+     * propagated through; zero if it didn't propagate through any.
+     *
+     * @pre
+     * This member is only available if #EXCEPTIONS4C_RETRY is nonzero.
+     */
+    int attempts;
+
+#endif
+
 };
 
 /**
- * @internal
- * @brief Represents the current status of exceptions.
+ * Represents an exception thrown while processing one element of a batch.
+ *
+ * @see e4c_batch
+ * @see BATCH_TRY
  */
-struct e4c_context {
-    unsigned char blocks;
-    struct e4c_exception thrown;
-    struct e4c_block {
-        unsigned char stage;
-        unsigned char uncaught;
-        jmp_buf jump;
-    } block[EXCEPTIONS4C_MAX_BLOCKS];
+struct e4c_batch_failure {
+    /** The index of the element that threw the exception. */
+    size_t index;
+
+    /** The exception thrown while processing the element. */
+    struct e4c_exception exception;
 };
 
 /**
- * @internal
- * @brief Returns the current exception block.
- */
-#define EXCEPTION_BLOCK                                                     \
+ * Collects the exceptions thrown while processing a batch of elements.
+ *
+ * The vector of failures MUST be allocated by the caller. When more elements
+ * fail than it can hold, the remaining failures are counted but not stored.
+ *
+ * Example:
+ * ```c
+ * struct e4c_batch_failure failures[16];
+ * struct e4c_batch batch = {failures, 16};
+ * ```
+ *
+ * @see BATCH_TRY
+ */
+struct e4c_batch {
+    /** The preallocated vector of failures. */
+    struct e4c_batch_failure *failure;
+
+    /** The maximum number of failures that can be stored. */
+    size_t capacity;
+
+    /** The number of elements that failed; it MAY exceed the capacity. */
+    size_t failed;
+};
+
+#if EXCEPTIONS4C_RETRY
+
+/**
+ * Represents a strategy to wait between the attempts of a #RETRY block.
+ *
+ * @see e4c_retry_policy
+ */
+enum e4c_backoff {
+    /** Attempts are made again immediately. */
+    BACKOFF_NONE,
+
+    /** Waits for a fixed delay between attempts. */
+    BACKOFF_FIXED,
+
+    /** Doubles the delay after each attempt, and adds random jitter. */
+    BACKOFF_EXPONENTIAL
+};
+
+/**
+ * Determines how #RETRY blocks behave between attempts.
+ *
+ * Example:
+ * ```c
+ * static const struct e4c_retry_policy policy = {
+ *   BACKOFF_EXPONENTIAL, 10, 1000, count_attempt
+ * };
+ *
+ * RETRY_POLICY(&policy);
+ * ```
+ *
+ * @pre
+ * This type is only available if #EXCEPTIONS4C_RETRY is nonzero.
+ *
+ * @see RETRY_POLICY
+ */
+struct e4c_retry_policy {
+    /** The strategy to wait between attempts. */
+    enum e4c_backoff backoff;
+
+    /** The base delay between attempts, in milliseconds. */
+    unsigned long delay;
+
+    /** The maximum delay between attempts, in milliseconds; or zero. */
+    unsigned long max_delay;
+
+    /**
+     * The function called after each failed attempt, or <tt>NULL</tt>.
+     *
+     * It receives the number of the attempt that failed, the delay before the
+     * next attempt (if any), and the exception thrown. It MUST NOT throw
+     * exceptions.
+     */
+    void (*on_attempt)(int attempt, unsigned long delay,
+        const struct e4c_exception *exception);
+};
+
+#endif
+
+#if EXCEPTIONS4C_ARENA_SIZE > 0
+
+/**
+ * @internal
+ * @brief Represents the unit of allocation of the scoped arena.
+ *
+ * Allocations are rounded up to whole units so that every pointer returned by
+ * #ARENA_ALLOC is suitably aligned for any of these types.
+ */
+union e4c_arena_unit {
+    long double number;
+    long long integer;
+    void *pointer;
+    void (*function)(void);
+};
+
+/**
+ * @internal
+ * @brief Returns the number of units of the scoped arena.
+ */
+#define EXCEPTION_ARENA_UNITS                                               \
+                                                                            \
+  ((EXCEPTIONS4C_ARENA_SIZE + sizeof(union e4c_arena_unit) - 1)             \
+    / sizeof(union e4c_arena_unit))
+
+#endif
+
+#if EXCEPTIONS4C_FLIGHT_RECORDER > 0
+
+/**
+ * @internal
+ * @brief The maximum length of the messages kept by the flight recorder.
+ */
+#define EXCEPTION_EVENT_MESSAGE 32
+
+/**
+ * @internal
+ * @brief Represents an exception that was thrown or caught.
+ */
+struct e4c_event {
+    e4c_exception_type type;
+    const char *name;
+    const char *file;
+    int line;
+    unsigned char caught;
+    unsigned char depth;
+    unsigned long long timestamp;
+    char message[EXCEPTION_EVENT_MESSAGE];
+};
+
+#endif
+
+#if EXCEPTIONS4C_LOCKS > 0 && EXCEPTIONS4C_LOCK_STATS > 0
+
+/**
+ * @internal
+ * @brief The number of buckets of the histograms of lock statistics.
+ */
+#define EXCEPTION_LOCK_BUCKETS 32
+
+/**
+ * Represents the contention measured at a #LOCKED block.
+ *
+ * Histograms count durations by powers of two: bucket <tt>n</tt> counts
+ * durations from <tt>2^n</tt> up to <tt>2^(n+1)</tt> nanoseconds. The first
+ * bucket also counts zero, and the last one also counts anything longer.
+ *
+ * @pre
+ * This type is only available if #EXCEPTIONS4C_LOCK_STATS is greater than
+ * zero.
+ *
+ * @see LOCK_STATS
+ */
+struct e4c_lock_site {
+    /** The source file of the block; or <tt>NULL</tt> if not used yet. */
+    const char *file;
+
+    /** The line number of the block. */
+    int line;
+
+    /** The number of times the lock was acquired. */
+    unsigned long acquired;
+
+    /** The number of times the lock was released by an exception. */
+    unsigned long unwound;
+
+    /** The histogram of the time spent waiting for the lock. */
+    unsigned long wait[EXCEPTION_LOCK_BUCKETS];
+
+    /** The histogram of the time the lock was held. */
+    unsigned long hold[EXCEPTION_LOCK_BUCKETS];
+};
+
+#endif
+
+#if EXCEPTIONS4C_LIVE_STATS > 0
+
+/**
+ * @internal
+ * @brief Identifies a segment of live statistics.
+ */
+#define EXCEPTION_LIVE_MAGIC 0x45344C53U
+
+/**
+ * @internal
+ * @brief The version of the layout of a segment of live statistics.
+ */
+#define EXCEPTION_LIVE_VERSION 1
+
+/**
+ * @internal
+ * @brief The maximum length of a name published in live statistics,
+ * including the terminating null character.
+ */
+#define EXCEPTION_LIVE_NAME 32
+
+/**
+ * @internal
+ * @brief The maximum length of a file published in live statistics,
+ * including the terminating null character.
+ */
+#define EXCEPTION_LIVE_FILE 64
+
+/**
+ * Represents the exceptions thrown from one site by one thread.
+ *
+ * @pre
+ * This type is only available if #EXCEPTIONS4C_LIVE_STATS is greater than
+ * zero.
+ *
+ * @see e4c_live_thread
+ */
+struct e4c_live_site {
+    /** The name of the exception type; or empty if the site is not used yet. */
+    char name[EXCEPTION_LIVE_NAME];
+
+    /** The end of the source file; or empty if unknown. */
+    char file[EXCEPTION_LIVE_FILE];
+
+    /** The line number in the source file; or zero if unknown. */
+    int line;
+
+    /** The number of exceptions thrown from this site. */
+    unsigned long thrown;
+
+    /** The number of exceptions thrown from this site that were caught. */
+    unsigned long caught;
+};
+
+/**
+ * Represents the live statistics published by one thread.
+ *
+ * Every member but the number of nested blocks is written under a sequence
+ * lock, so readers SHOULD copy them via #LIVE_STATS_SNAPSHOT.
+ *
+ * @pre
+ * This type is only available if #EXCEPTIONS4C_LIVE_STATS is greater than
+ * zero.
+ *
+ * @see e4c_live_segment
+ */
+struct e4c_live_thread {
+    /** The sequence lock; it is odd while the statistics are being written. */
+    atomic_uint sequence;
+
+    /** The current number of nested blocks. */
+    atomic_uint depth;
+
+    /** The maximum number of nested blocks. */
+    atomic_uint max_depth;
+
+    /** The number of exceptions thrown. */
+    unsigned long thrown;
+
+    /** The number of exceptions caught. */
+    unsigned long caught;
+
+    /** The number of exceptions that terminated the program. */
+    unsigned long terminated;
+
+    /** The number of exceptions thrown from sites that were not published. */
+    unsigned long dropped;
+
+    /** The throw sites; as many as the segment says. */
+    struct e4c_live_site site[];
+};
+
+/**
+ * Represents a segment of shared memory that contains live statistics.
+ *
+ * The segment of each process is named <tt>/exceptions4c-PID</tt>. This
+ * header is followed by the statistics of each thread, aligned to 64 bytes.
+ *
+ * @pre
+ * This type is only available if #EXCEPTIONS4C_LIVE_STATS is greater than
+ * zero.
+ *
+ * @see LIVE_STATS_OPEN
+ * @see LIVE_STATS_MAP
+ */
+struct e4c_live_segment {
+    /** Identifies the segment; it is written once the segment is ready. */
+    atomic_uint magic;
+
+    /** The version of the layout of the segment. */
+    unsigned version;
+
+    /** The maximum number of threads. */
+    unsigned threads;
+
+    /** The number of throw sites per thread. */
+    unsigned sites;
+
+    /** The number of threads attached so far; it MAY exceed the maximum. */
+    atomic_uint attached;
+
+    /** The process that publishes the statistics. */
+    long pid;
+
+    /** The total size of the segment, in bytes. */
+    size_t size;
+};
+
+#endif
+
+#if EXCEPTIONS4C_LOCKS > 0
+
+/**
+ * @internal
+ * @brief Represents a lock held by a #LOCKED block.
+ */
+struct e4c_held_lock {
+    void *lock;
+    unsigned char kind;
+    unsigned char running;
+#if EXCEPTIONS4C_LOCK_STATS > 0
+    struct e4c_lock_site *site;
+    unsigned long long acquired;
+#endif
+};
+
+#endif
+
+/**
+ * @internal
+ * @brief Represents the current status of exceptions.
+ */
+struct e4c_context {
+    unsigned char blocks;
+    struct e4c_exception thrown;
+    struct e4c_block {
+#if EXCEPTIONS4C_DEADLINES && EXCEPTIONS4C_DEADLINE_SIGNAL
+        volatile unsigned char stage;
+#else
+        unsigned char stage;
+#endif
+        unsigned char uncaught;
+        const e4c_exception_type *handles;
+        size_t index;
+#if EXCEPTIONS4C_ARENA_SIZE > 0
+        size_t arena;
+#endif
+#if EXCEPTIONS4C_LOCKS > 0
+        unsigned char locks;
+#endif
+#if EXCEPTIONS4C_DEADLINES
+        unsigned long long deadline;
+#endif
+        jmp_buf jump;
+    } block[EXCEPTIONS4C_MAX_BLOCKS];
+#if EXCEPTIONS4C_ARENA_SIZE > 0
+    struct e4c_arena {
+        size_t used;
+        union e4c_arena_unit memory[EXCEPTION_ARENA_UNITS];
+    } arena;
+#endif
+#if EXCEPTIONS4C_CANCELLATION
+    atomic_int cancelled;
+#endif
+#if EXCEPTIONS4C_DEADLINES
+    volatile unsigned long long deadline;
+#endif
+#if EXCEPTIONS4C_DEADLINES && EXCEPTIONS4C_DEADLINE_SIGNAL
+    volatile sig_atomic_t busy;
+#endif
+#if EXCEPTIONS4C_FLIGHT_RECORDER > 0
+    struct e4c_recorder {
+        unsigned long events;
+        unsigned long printed;
+        struct e4c_event event[EXCEPTIONS4C_FLIGHT_RECORDER];
+    } recorder;
+#endif
+#if EXCEPTIONS4C_FAULT_INJECTION
+    struct e4c_faults {
+        int active;
+        const char *type;
+        size_t type_length;
+        const char *file;
+        size_t file_length;
+        int line;
+        unsigned long every;
+        unsigned long calls;
+        unsigned long long threshold;
+        unsigned long long random;
+        unsigned long injected;
+    } faults;
+#endif
+#if EXCEPTIONS4C_RETRY
+    struct e4c_retry {
+        const struct e4c_retry_policy *policy;
+        unsigned long long random;
+    } retry;
+#endif
+#if EXCEPTIONS4C_LOCKS > 0
+    struct e4c_locks {
+        unsigned char held;
+        struct e4c_held_lock lock[EXCEPTIONS4C_LOCKS];
+#if EXCEPTIONS4C_LOCK_STATS > 0
+        struct e4c_lock_site site[EXCEPTIONS4C_LOCK_STATS];
+#endif
+    } locks;
+#endif
+#if EXCEPTIONS4C_LIVE_STATS > 0
+    struct e4c_live {
+        struct e4c_live_thread *thread;
+        struct e4c_live_site *current;
+        unsigned max_depth;
+        struct e4c_live_key {
+            const char *name;
+            const char *file;
+            int line;
+            int used;
+        } key[EXCEPTIONS4C_LIVE_STATS];
+    } live;
+#endif
+};
+
+/**
+ * @internal
+ * @brief Returns the current exception block.
+ */
+#define EXCEPTION_BLOCK                                                     \
                                                                             \
   exceptions4c.block[exceptions4c.blocks - 1]
 
@@ -236,340 +1097,2800 @@ struct e4c_context {
                                                                             \
   exceptions4c.blocks > 0 && exceptions4c.blocks <= EXCEPTIONS4C_MAX_BLOCKS
 
+#if EXCEPTIONS4C_ARENA_SIZE > 0
+
+/**
+ * @internal
+ * @brief Saves the mark of the scoped arena before entering a block.
+ */
+#define EXCEPTION_ARENA_ENTER                                               \
+                                                                            \
+  (EXCEPTION_BLOCK.arena = exceptions4c.arena.used)
+
+/**
+ * @internal
+ * @brief Releases the memory allocated inside a block before leaving it.
+ */
+#define EXCEPTION_ARENA_LEAVE                                               \
+                                                                            \
+  (exceptions4c.arena.used = EXCEPTION_BLOCK.arena)
+
+#else
+
+/**
+ * @internal
+ * @brief Saves the mark of the scoped arena before entering a block.
+ */
+#define EXCEPTION_ARENA_ENTER                                               \
+                                                                            \
+  ((void) 0)
+
+/**
+ * @internal
+ * @brief Releases the memory allocated inside a block before leaving it.
+ */
+#define EXCEPTION_ARENA_LEAVE                                               \
+                                                                            \
+  ((void) 0)
+
+#endif
+
+#if EXCEPTIONS4C_DEADLINES
+
+/**
+ * @internal
+ * @brief Saves the deadline of the outer block before entering a block.
+ */
+#define EXCEPTION_DEADLINE_ENTER                                            \
+                                                                            \
+  (EXCEPTION_BLOCK.deadline = exceptions4c.deadline)
+
+/**
+ * @internal
+ * @brief Restores the deadline of the outer block before leaving a block.
+ */
+#define EXCEPTION_DEADLINE_LEAVE                                            \
+                                                                            \
+  (exceptions4c.deadline = EXCEPTION_BLOCK.deadline)
+
+#else
+
+/**
+ * @internal
+ * @brief Saves the deadline of the outer block before entering a block.
+ */
+#define EXCEPTION_DEADLINE_ENTER                                            \
+                                                                            \
+  ((void) 0)
+
+/**
+ * @internal
+ * @brief Restores the deadline of the outer block before leaving a block.
+ */
+#define EXCEPTION_DEADLINE_LEAVE                                            \
+                                                                            \
+  ((void) 0)
+
+#endif
+
+#if EXCEPTIONS4C_DEADLINES && EXCEPTIONS4C_DEADLINE_SIGNAL
+
+/**
+ * @internal
+ * @brief Keeps the deadline signal from jumping while blocks are updated.
+ *
+ * The fence keeps the compiler from moving the updates before the flag.
+ */
+#define EXCEPTION_SIGNAL_BUSY                                               \
+                                                                            \
+  (exceptions4c.busy = 1, atomic_signal_fence(memory_order_seq_cst))
+
+/**
+ * @internal
+ * @brief Lets the deadline signal jump again, once the current block is
+ * armed.
+ */
+#define EXCEPTION_SIGNAL_IDLE                                               \
+                                                                            \
+  (atomic_signal_fence(memory_order_seq_cst), exceptions4c.busy = 0)
+
+#else
+
+/**
+ * @internal
+ * @brief Keeps the deadline signal from jumping while blocks are updated.
+ */
+#define EXCEPTION_SIGNAL_BUSY                                               \
+                                                                            \
+  ((void) 0)
+
+/**
+ * @internal
+ * @brief Lets the deadline signal jump again, once the current block is
+ * armed.
+ */
+#define EXCEPTION_SIGNAL_IDLE                                               \
+                                                                            \
+  ((void) 0)
+
+#endif
+
+#if EXCEPTIONS4C_LOCKS > 0
+
+/**
+ * @internal
+ * @brief Saves the number of held locks before entering a block.
+ */
+#define EXCEPTION_LOCKS_ENTER                                               \
+                                                                            \
+  (EXCEPTION_BLOCK.locks = exceptions4c.locks.held)
+
+#else
+
+/**
+ * @internal
+ * @brief Saves the number of held locks before entering a block.
+ */
+#define EXCEPTION_LOCKS_ENTER                                               \
+                                                                            \
+  ((void) 0)
+
+#endif
+
+/**
+ * @internal
+ * @brief Saves the state of the current exception block before entering it.
+ */
+#define EXCEPTION_BLOCK_ENTER                                               \
+                                                                            \
+  ((void) EXCEPTION_ARENA_ENTER, (void) EXCEPTION_DEADLINE_ENTER,           \
+    (void) EXCEPTION_LOCKS_ENTER)
+
+/**
+ * @internal
+ * @brief Restores the state of the current exception block before leaving it.
+ */
+#define EXCEPTION_BLOCK_LEAVE                                               \
+                                                                            \
+  ((void) EXCEPTION_ARENA_LEAVE, (void) EXCEPTION_DEADLINE_LEAVE)
+
+#if defined(__GNUC__) || defined(__clang__)
+
+/**
+ * @internal
+ * @brief Declares that a function never returns to its caller.
+ */
+#define EXCEPTIONS4C_NORETURN __attribute__((noreturn))
+
+#elif defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L
+
+/**
+ * @internal
+ * @brief Declares that a function never returns to its caller.
+ */
+#define EXCEPTIONS4C_NORETURN _Noreturn
+
+#else
+
+/**
+ * @internal
+ * @brief Declares that a function never returns to its caller.
+ */
+#define EXCEPTIONS4C_NORETURN
+
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+
+/**
+ * @internal
+ * @brief Declares that a function is rarely called and must not be inlined.
+ */
+#define EXCEPTIONS4C_COLD __attribute__((noinline, cold, unused))
+
+/**
+ * @internal
+ * @brief Hints that a condition is rarely true.
+ */
+#define EXCEPTIONS4C_UNLIKELY(condition) __builtin_expect(!!(condition), 0)
+
+/**
+ * @internal
+ * @brief Declares that a function must not be inlined.
+ */
+#define EXCEPTIONS4C_NOINLINE __attribute__((noinline, unused))
+
+#elif defined(_MSC_VER)
+
+/**
+ * @internal
+ * @brief Declares that a function is rarely called and must not be inlined.
+ */
+#define EXCEPTIONS4C_COLD __declspec(noinline)
+
+/**
+ * @internal
+ * @brief Hints that a condition is rarely true.
+ */
+#define EXCEPTIONS4C_UNLIKELY(condition) (condition)
+
+/**
+ * @internal
+ * @brief Declares that a function must not be inlined.
+ */
+#define EXCEPTIONS4C_NOINLINE __declspec(noinline)
+
+#else
+
+/**
+ * @internal
+ * @brief Declares that a function is rarely called and must not be inlined.
+ */
+#define EXCEPTIONS4C_COLD
+
+/**
+ * @internal
+ * @brief Hints that a condition is rarely true.
+ */
+#define EXCEPTIONS4C_UNLIKELY(condition) (condition)
+
+/**
+ * @internal
+ * @brief Declares that a function must not be inlined.
+ */
+#define EXCEPTIONS4C_NOINLINE
+
+#endif
+
+#ifndef NDEBUG
+
+/**
+ * @internal
+ * @brief Returns the location in the source code, as helper arguments.
+ */
+#define EXCEPTION_SITE                                                      \
+                                                                            \
+  __FILE__, __LINE__
+
+#else
+
+/**
+ * @internal
+ * @brief Returns the location in the source code, as helper arguments.
+ */
+#define EXCEPTION_SITE                                                      \
+                                                                            \
+  NULL, 0
+
+#endif
+
+#if EXCEPTIONS4C_FLIGHT_RECORDER > 0
+
+/**
+ * @internal
+ * @brief Prints the events recorded by the flight recorder.
+ */
+#define EXCEPTION_DUMP                                                      \
+                                                                            \
+  e4c_print_history()
+
+#else
+
+/**
+ * @internal
+ * @brief Prints the events recorded by the flight recorder.
+ */
+#define EXCEPTION_DUMP                                                      \
+                                                                            \
+  ((void) 0)
+
+#endif
+
+#if EXCEPTIONS4C_OUT_OF_LINE
+
+/**
+ * @internal
+ * @brief Declares a helper function that handles a rare path.
+ */
+#define EXCEPTIONS4C_RARE static EXCEPTIONS4C_COLD
+
+/**
+ * @internal
+ * @brief Determines whether a handler block is to be executed.
+ */
+#define EXCEPTION_HANDLER(condition)                                        \
+                                                                            \
+  EXCEPTIONS4C_UNLIKELY(condition)
+
+#else
+
+/**
+ * @internal
+ * @brief Declares a helper function that handles a rare path.
+ */
+#define EXCEPTIONS4C_RARE static inline
+
+/**
+ * @internal
+ * @brief Determines whether a handler block is to be executed.
+ */
+#define EXCEPTION_HANDLER(condition)                                        \
+                                                                            \
+  (condition)
+
+#endif
+
+/**
+ * Contains the current status of exceptions.
+ *
+ * You MUST define this global variable for your program.
+ *
+ * ```c
+ * struct e4c_context exceptions4c = {0};
+ * ```
+ *
+ * @remark
+ * If #EXCEPTIONS4C_THREAD_LOCAL is defined, the variable MUST be defined with
+ * the same storage class.
+ *
+ * ```c
+ * EXCEPTIONS4C_THREAD_LOCAL struct e4c_context exceptions4c = {0};
+ * ```
+ */
+extern EXCEPTIONS4C_THREAD_LOCAL struct e4c_context exceptions4c;
+
+/**
+ * Introduces a block of code that may throw exceptions during execution.
+ *
+ * The #TRY block is used to define a section of code where exceptions MAY
+ * occur. It allows you to handle exceptions gracefully using other blocks that
+ * follow it. If an exception occurs, control is transferred to the appropriate
+ * block.
+ *
+ * A single #TRY block MAY be followed by:
+ *
+ * 1. One or more #CATCH blocks to handle specific types of exceptions.
+ * 2. Optionally, one #CATCH_ALL block to handle all exception types (if
+ *    present, it MUST appear after all #CATCH blocks).
+ * 3. Optionally, one #FINALLY block to execute cleanup code, regardless of
+ *    whether an exception was thrown or caught.
+ *
+ * @attention
+ * These blocks MUST NOT be exited through any of: <tt>goto</tt>,
+ * <tt>break</tt>, <tt>continue</tt>, or <tt>return</tt>.
+ *
+ * @important
+ * Local variables in the function containing the #TRY block MUST be
+ * <tt>volatile</tt> because these blocks invoke <tt>setjump</tt> and their
+ * values would be indeterminate if they had been changed since the invocation.
+ * Use #TRY_CALL to avoid this requirement in performance-sensitive code.
+ *
+ * Example: @snippet pet-store.c try
+ *
+ * @see CATCH
+ * @see CATCH_ALL
+ * @see FINALLY
+ * @see TRY_CALL
+ */
+#define TRY                                                                 \
+                                                                            \
+  EXCEPTION_TRY(NULL, (void) 0)
+
+/**
+ * Introduces a block of code that may throw exceptions during execution, and
+ * publishes the types of exceptions that its #CATCH blocks handle.
+ *
+ * This macro works just like #TRY, but it lets #THROW search for a handler
+ * before transferring control. When an exception propagates, blocks introduced
+ * by this macro whose types don't match are discarded without jumping into
+ * them, so control jumps once, directly to the innermost block that actually
+ * catches the exception or has cleanup to run.
+ *
+ * A block followed by #CATCH_ALL or #FINALLY has cleanup to run for exceptions
+ * of any type, so it is always jumped into, just like a #TRY block. The
+ * handlers are visited once, before the body, to find out.
+ *
+ * @param ... The types of exceptions handled by the following #CATCH blocks.
+ *
+ * @see TRY
+ * @see CATCH
+ */
+#define TRY_CATCHING(...)                                                   \
+                                                                            \
+  EXCEPTION_TRY(((const e4c_exception_type []) {__VA_ARGS__, NULL}),      \
+    EXCEPTION_DISCOVER)
+
+/**
+ * @internal
+ * @brief Rewinds a new block, so that its handlers are visited once in stage
+ * zero, before its body, to discover whether it has cleanup to run.
+ */
+#define EXCEPTION_DISCOVER                                                  \
+                                                                            \
+  (EXCEPTION_BLOCK.stage = (unsigned char) -1)
+
+/**
+ * Introduces a block that calls a function that may throw exceptions during
+ * execution.
+ *
+ * This macro works just like #TRY, but instead of a block of code, it calls
+ * <tt>function</tt> passing <tt>argument</tt> to it, through a helper that is
+ * never inlined. The body of the function runs in its own stack frame, after
+ * <tt>setjmp</tt> has been invoked, so its local variables MAY be kept in
+ * registers and don't need to be <tt>volatile</tt>.
+ *
+ * This form SHOULD be preferred over #TRY for performance-sensitive code, such
+ * as numeric loops that update loop-carried accumulators. Results SHOULD be
+ * returned through <tt>argument</tt>.
+ *
+ * @remark
+ * GCC nested functions MAY also be passed as <tt>function</tt>. With Clang,
+ * #TRY_BLOCK MAY be used to call a block instead.
+ *
+ * Example:
+ * ```c
+ * static void sum(void *argument) {
+ *   struct job *job = argument;
+ *   double total = 0;
+ *   for (size_t index = 0; index < job->length; index++) {
+ *     total += parse(job->values[index]);
+ *   }
+ *   job->total = total;
+ * }
+ *
+ * TRY_CALL(sum, &job) CATCH (PARSE_ERROR) {
+ *   job.total = 0;
+ * }
+ * ```
+ *
+ * @param function The function to call; it MUST take a <tt>void *</tt>.
+ * @param argument The argument to pass to <tt>function</tt>.
+ *
+ * @see TRY
+ */
+#define TRY_CALL(function, argument)                                        \
+                                                                            \
+  TRY e4c_call((function), (argument));
+
+#ifdef __BLOCKS__
+
+/**
+ * Introduces a block that calls a Clang block that may throw exceptions during
+ * execution.
+ *
+ * This macro works just like #TRY_CALL, but it calls a block that takes no
+ * arguments instead of a function.
+ *
+ * @pre
+ * This macro is only available if blocks are supported by the compiler.
+ *
+ * @param block The block to call.
+ *
+ * @see TRY_CALL
+ */
+#define TRY_BLOCK(block)                                                    \
+                                                                            \
+  TRY e4c_call_block(block);
+
+#endif
+
+#if EXCEPTIONS4C_DEADLINES
+
+/**
+ * Introduces a block of code that may throw exceptions during execution, and
+ * MUST complete within a budget of time.
+ *
+ * This macro works just like #TRY, but it records a deadline for its body.
+ * When the deadline has passed, the next #CHECKPOINT reached by the current
+ * thread will #THROW a #TIMEOUT exception.
+ *
+ * Nested blocks inherit the tighter of their own deadline and the deadline of
+ * the outer block. The deadline is disarmed when the #TIMEOUT exception is
+ * thrown, so the following #CATCH and #FINALLY blocks are not bound by it.
+ *
+ * @pre
+ * This macro is only available if #EXCEPTIONS4C_DEADLINES is nonzero.
+ *
+ * @param budget The maximum amount of time, in milliseconds, that the body of
+ *   this block MAY take.
+ *
+ * @see CHECKPOINT
+ * @see TIMEOUT
+ */
+#define TRY_WITHIN(budget)                                                  \
+                                                                            \
+  EXCEPTION_TRY(NULL, EXCEPTION_DEADLINE_SET(budget))
+
+/**
+ * @internal
+ * @brief Sets the deadline of the current block, unless the outer deadline is
+ * tighter.
+ */
+#define EXCEPTION_DEADLINE_SET(budget)                                      \
+                                                                            \
+  e4c_deadline((unsigned long long) (budget))
+
+#endif
+
+/**
+ * @internal
+ * @brief Introduces a block of code that may throw exceptions during
+ * execution, optionally publishing the types of exceptions it handles.
+ */
+#define EXCEPTION_TRY(handled_types, setup)                                 \
+                                                                            \
+  for (                                                                     \
+    e4c_enter((handled_types), EXCEPTION_SITE),                             \
+    (void) (setup),                                                         \
+    (void) setjmp(EXCEPTION_BLOCK.jump);                                    \
+                                                                            \
+    e4c_next(4);                                                            \
+  )                                                                         \
+    if (e4c_stage(1))
+
+/**
+ * Introduces a loop that processes a batch of elements, collecting the
+ * exceptions thrown by each of them and continuing with the next one.
+ *
+ * This macro works like a <tt>for</tt> loop that sets <tt>index</tt> from zero
+ * to <tt>count - 1</tt>, but it arms a single jump buffer for the whole batch
+ * instead of one per element. When the body throws an exception, the type,
+ * message, and index of the element are appended to <tt>batch</tt>, the jump
+ * buffer is armed again, and processing resumes at the next element.
+ *
+ * Each failed element is cleaned up as if it had its own #TRY block: the
+ * memory it allocated via #ARENA_ALLOC is released, the deadline of the loop is
+ * restored, and the locks it acquired via #LOCKED are released.
+ *
+ * After the loop, the failures MAY be inspected through <tt>batch</tt>, or
+ * aggregated into a single exception via #BATCH_RETHROW.
+ *
+ * @attention
+ * The body of this loop MUST NOT be exited through any of: <tt>goto</tt>,
+ * <tt>break</tt>, or <tt>return</tt>. It MAY be exited through
+ * <tt>continue</tt> to skip to the next element.
+ *
+ * @important
+ * Just like with #TRY, local variables changed in the body of the loop MUST be
+ * <tt>volatile</tt>. The <tt>index</tt> itself is restored after each failure,
+ * so it doesn't need to be.
+ *
+ * Example:
+ * ```c
+ * struct e4c_batch_failure failures[16];
+ * struct e4c_batch batch = {failures, 16};
+ * size_t index;
+ *
+ * BATCH_TRY (index, count, &batch) {
+ *   transform(&records[index]);
+ * }
+ * ```
+ *
+ * @param index The variable that holds the index of the current element.
+ * @param count The number of elements of the batch.
+ * @param batch A pointer to the #e4c_batch that collects the failures.
+ *
+ * @see e4c_batch
+ * @see BATCH_RETHROW
+ */
+#define BATCH_TRY(index, count, batch)                                      \
+                                                                            \
+  for (                                                                     \
+    e4c_enter(NULL, EXCEPTION_SITE),                                        \
+    EXCEPTION_BLOCK.stage = 1,                                              \
+    EXCEPTION_BLOCK.index = 0,                                              \
+    (void) setjmp(EXCEPTION_BLOCK.jump),                                    \
+    (void) (EXCEPTION_BLOCK.uncaught && (e4c_batch_fail(batch), 0)),        \
+    (void) EXCEPTION_SIGNAL_IDLE;                                           \
+                                                                            \
+    EXCEPTION_BLOCK_RANGE_CHECK                                             \
+      && (((index) = EXCEPTION_BLOCK.index) < (count) || e4c_leave());      \
+    EXCEPTION_BLOCK.index++                                                 \
+  )
+
+/**
+ * Throws a single exception that aggregates the failures of a batch.
+ *
+ * If any element of the batch failed, this macro throws an exception of the
+ * same type as the first failure, whose message includes the number of failed
+ * elements and the index and message of the first one. Otherwise, it does
+ * nothing.
+ *
+ * @pre
+ * The capacity of <tt>batch</tt> MUST be at least one.
+ *
+ * @param batch A pointer to the #e4c_batch that collected the failures.
+ *
+ * @see BATCH_TRY
+ */
+#define BATCH_RETHROW(batch)                                                \
+                                                                            \
+  (e4c_batch_aggregate(batch) ? EXCEPTION_RETHROW : (void) 0)
+
+#if EXCEPTIONS4C_RETRY
+
+/**
+ * Introduces a block of code that is attempted again when it throws transient
+ * exceptions.
+ *
+ * When the body of this block throws an exception of any of the given types,
+ * it is attempted again, up to <tt>max_attempts</tt> times, backing off as
+ * determined by the current #RETRY_POLICY. The same block slot and jump buffer
+ * are reused across attempts, so retries don't nest.
+ *
+ * After the last attempt, the exception propagates with the number of attempts
+ * recorded in its <tt>attempts</tt> member. Exceptions of any other type
+ * propagate immediately.
+ *
+ * @pre
+ * This macro is only available if #EXCEPTIONS4C_RETRY is nonzero.
+ *
+ * @attention
+ * A block introduced by this macro MUST NOT be followed by #CATCH,
+ * #CATCH_ALL, or #FINALLY blocks; it SHOULD be nested in a #TRY block to
+ * handle the exception thrown by the last attempt. The body of this block
+ * MUST NOT be exited through any of: <tt>goto</tt>, <tt>break</tt>,
+ * <tt>continue</tt>, or <tt>return</tt>.
+ *
+ * @important
+ * Just like with #TRY, local variables changed in the body of this block MUST
+ * be <tt>volatile</tt>.
+ *
+ * Example:
+ * ```c
+ * TRY {
+ *   RETRY (3, CONNECTION_RESET, TIMEOUT) {
+ *     response = send_request(request);
+ *   }
+ * } CATCH (CONNECTION_RESET) {
+ *   printf("Gave up after %d attempts\n", EXCEPTION.attempts);
+ * }
+ * ```
+ *
+ * @param max_attempts The maximum number of times the body is attempted.
+ * @param ... The types of exceptions that are considered transient.
+ *
+ * @see RETRY_POLICY
+ * @see EXCEPTIONS4C_RETRY
+ */
+#define RETRY(max_attempts, ...)                                            \
+                                                                            \
+  for (                                                                     \
+    e4c_enter(((const e4c_exception_type []) {__VA_ARGS__, NULL}),          \
+      EXCEPTION_SITE),                                                      \
+    EXCEPTION_BLOCK.index = 1,                                              \
+    (void) setjmp(EXCEPTION_BLOCK.jump),                                    \
+    (void) (EXCEPTION_BLOCK.uncaught && (e4c_retry(max_attempts), 0));      \
+                                                                            \
+    e4c_next(2);                                                            \
+  )
+
+/**
+ * Sets the policy that determines how #RETRY blocks behave between attempts.
+ *
+ * Until a policy is set, attempts are made again immediately.
+ *
+ * @pre
+ * This macro is only available if #EXCEPTIONS4C_RETRY is nonzero.
+ *
+ * @param retry_policy A pointer to the #e4c_retry_policy to use from now on by
+ *   the current thread, or <tt>NULL</tt>.
+ *
+ * @see RETRY
+ */
+#define RETRY_POLICY(retry_policy)                                          \
+                                                                            \
+  (exceptions4c.retry.policy = (retry_policy))
+
+#endif
+
+/**
+ * Introduces a block of code that handles exceptions thrown by a preceding #TRY
+ * block.
+ *
+ * Use this macro to to handle a specific type of exceptions when they occur.
+ *
+ * If <tt>type</tt> is equal to the type of the [thrown exception](#EXCEPTION),
+ * then this block will be used to handle it.
+ *
+ * One or more #CATCH blocks MAY follow a #TRY block. If <tt>type</tt> doesn't
+ * match the thrown exception, then this block will be ignored, and the
+ * exception MAY be caught by the following #CATCH or #CATCH_ALL blocks.
+ *
+ * @attention
+ * These blocks MUST NOT be exited through any of: <tt>goto</tt>,
+ * <tt>break</tt>, <tt>continue</tt>, or <tt>return</tt>.
+ *
+ * @param exception_type The type of exception to catch.
+ *
+ * Example: @snippet pet-store.c catch
+ *
+ * @see TRY
+ * @see CATCH_ALL
+ */
+#define CATCH(exception_type)                                               \
+                                                                            \
+    else if (EXCEPTION_HANDLER(EXCEPTION_BLOCK.uncaught                     \
+      && e4c_catch((exception_type), EXCEPTION_SITE)))
+
+/**
+ * Introduces a block of code that handles any exception thrown by a preceding
+ * #TRY block, regardless of its type.
+ *
+ * The #CATCH_ALL block works like a general #CATCH block that does not require
+ * specifying the type of exception to handle. It MAY be used as a fallback for
+ * catching all exceptions, including those not explicitly declared in other
+ * #CATCH blocks.
+ *
+ * Only one #CATCH_ALL block is allowed per #TRY block, and it MUST appear after
+ * all type-specific #CATCH blocks if any are present.
+ *
+ * @remark
+ * Using a #CATCH_ALL block is useful for logging, debugging, or handling
+ * unexpected exceptions that don't fit into specific categories. However,
+ * specific #CATCH blocks SHOULD be used whenever possible to maintain clarity
+ * and precise control over exception handling.
+ *
+ * @attention
+ * These blocks MUST NOT be exited through any of: <tt>goto</tt>,
+ * <tt>break</tt>, <tt>continue</tt>, or <tt>return</tt>.
+ *
+ * Example: @snippet pet-store.c catch_all
+ *
+ * @see TRY
+ * @see CATCH
+ */
+#define CATCH_ALL                                                           \
+                                                                            \
+    else if (EXCEPTION_HANDLER(e4c_cleanup(2) && EXCEPTION_BLOCK.uncaught   \
+      && e4c_catch(EXCEPTION.type, EXCEPTION_SITE)))
+
+/**
+ * Introduces a block of code that is executed after a #TRY block, regardless of
+ * whether an exception was thrown or not.
+ *
+ * Use this macro to run a block, no matter whether an exception happens or not.
+ *
+ * A #FINALLY block MUST be preceded by a single #TRY block, after all the
+ * accompanying #CATCH and #CATCH_ALL blocks (if any). Only one #FINALLY block
+ * is allowed per block.
+ *
+ * @attention
+ * These blocks MUST NOT be exited through any of: <tt>goto</tt>,
+ * <tt>break</tt>, <tt>continue</tt>, or <tt>return</tt>.
+ *
+ * @remark
+ * This macro SHOULD be used to release resources, close files, or perform
+ * cleanup tasks.
+ *
+ * Example: @snippet pet-store.c finally
+ *
+ * @see TRY
+ */
+#define FINALLY                                                             \
+                                                                            \
+    else if (e4c_cleanup(3))
+
+/**
+ * Throws an exception, interrupting the normal flow of execution.
+ *
+ * #THROW is used within a #TRY block, a #CATCH block, or any other function to
+ * signal that an error has occurred. The thrown exception will be of the
+ * specified <tt>type</tt>, and it MAY be handled by a preceding #CATCH block.
+ *
+ * If a thrown exception is not handled by any of the #CATCH blocks in the
+ * current function, it propagates up the call stack to the function that called
+ * the current function. This continues until the exception is either handled by
+ * a #CATCH block higher in the stack, or it reaches the top level of the
+ * program. If no #CATCH block handles the exception, the program terminates and
+ * an error message is printed to the console.
+ *
+ * @remark
+ * The error message will be copied as it is into the thrown #EXCEPTION. To use
+ * a formatted error message, use #THROWF instead. If no message is specified,
+ * then the default message for the exception type will be used.
+ *
+ * @important
+ * Control never returns to the #THROW point.
+ *
+ * Example: @snippet pet-store.c throw
+ *
+ * @param exception_type The type of the exception to throw.
+ * @param error_message The error message.
+ *
+ * @see THROWF
+ * @see CATCH
+ * @see CATCH_ALL
+ */
+#define THROW(exception_type, error_message)                                \
+                                                                            \
+  e4c_throw((exception_type), #exception_type, (error_message),             \
+    EXCEPTION_SITE)
+
+#ifndef THROWF
+
+/**
+ * Throws an exception with a formatted error message.
+ *
+ * This macro works just like #THROW, but it allows you to format the error
+ * message, just as you would with <tt>printf</tt>.
+ *
+ * @important
+ * Control never returns to the #THROW point.
+ *
+ * Example: @snippet pet-store.c throw
+ *
+ * @param exception_type The type of the exception to throw.
+ * @param format The error message.
+ * @param ... A list of arguments that will be formatted according to
+ *   <tt>format</tt>.
+ *
+ * @see THROW
+ * @see CATCH
+ * @see CATCH_ALL
+ */
+#define THROWF(exception_type, format, ...)                                 \
+                                                                            \
+  e4c_throwf((exception_type), #exception_type, EXCEPTION_SITE,             \
+    (format), __VA_ARGS__)
+
+#endif
+
+/**
+ * Retrieves the last exception that was thrown.
+ *
+ * @remark
+ * This macro SHOULD be used in the body of a #CATCH or #CATCH_ALL block to
+ * inspect the exception being handled. It MAY also be used in the body of a
+ * #FINALLY block to determine if an exception was thrown in the corresponding
+ * #TRY block, or during the execution of a #CATCH or #CATCH_ALL block.
+ *
+ * Example: @snippet pet-store.c catch_all_get_exception
+ *
+ * @return The last exception that was thrown.
+ *
+ * @see e4c_exception
+ * @see THROW
+ * @see CATCH
+ * @see FINALLY
+ * @see EXCEPTION_IS_UNCAUGHT
+ */
+#define EXCEPTION                                                           \
+                                                                            \
+  exceptions4c.thrown
+
+/**
+ * Determines whether the thrown exception was not caught.
+ *
+ * An exception is considered "uncaught" if no matching #CATCH or #CATCH_ALL
+ * block has been executed for it. In other words, this macro evaluates to a
+ * truthy value if the exception has bypassed all specific exception-handling
+ * logic and is propagating further. And it evaluates to a falsy value if no
+ * exception was thrown in the #TRY block, or if an exception was successfully
+ * caught.
+ *
+ * @remark
+ * This macro SHOULD be used exclusively in the body of a #FINALLY block to
+ * check whether an exception thrown during the #TRY block has propagated past
+ * all #CATCH and #CATCH_ALL blocks without being handled.
+ *
+ * Example: @snippet pet-store.c is_uncaught
+ *
+ * @return A truthy value if the current exception (if any) has not yet been
+ *   handled by any #CATCH or #CATCH_ALL block; a falsy value otherwise.
+ *
+ * @see FINALLY
+ * @see EXCEPTION
+ */
+#define EXCEPTION_IS_UNCAUGHT                                               \
+                                                                            \
+  (EXCEPTION_BLOCK_RANGE_CHECK && EXCEPTION_BLOCK.uncaught)
+
+#ifndef NDEBUG
+
+/**
+ * Prints the current exception to standard error output and flushes it.
+ *
+ * @see EXCEPTION
+ */
+#define EXCEPTION_PRINT                                                     \
+                                                                            \
+  (fprintf(stderr, "\n%s: %s\n    at %s:%d\n", EXCEPTION.name,              \
+    EXCEPTION.message, EXCEPTION.file != NULL ? EXCEPTION.file : "?",       \
+    EXCEPTION.line))
+
+#else
+
+/**
+ * Prints the current exception to standard error output and flushes it.
+ *
+ * @see EXCEPTION
+ */
+#define EXCEPTION_PRINT                                                     \
+                                                                            \
+  (fprintf(stderr, "\n%s: %s\n", EXCEPTION.name, EXCEPTION.message))
+
+#endif
+
+/**
+ * Throws the current exception again.
+ *
+ * @remark
+ * This macro SHOULD be used in the body of #CATCH or #CATCH_ALL blocks to throw
+ * the exception that is currently being handled.
+ *
+ * @see CATCH
+ * @see CATCH_ALL
+ */
+#define EXCEPTION_RETHROW                                                   \
+                                                                            \
+  e4c_rethrow(EXCEPTION_SITE)
+
+/**
+ * @internal
+ * @brief Calls a function in its own stack frame.
+ */
+static EXCEPTIONS4C_NOINLINE void e4c_call(void (*function)(void *),
+    void *argument) {
+    function(argument);
+}
+
+#ifdef __BLOCKS__
+
+/**
+ * @internal
+ * @brief Calls a block in its own stack frame.
+ */
+static EXCEPTIONS4C_NOINLINE void e4c_call_block(void (^block)(void)) {
+    block();
+}
+
+#endif
+
+#if EXCEPTIONS4C_FLIGHT_RECORDER > 0
+
+/**
+ * @internal
+ * @brief Records an exception that was thrown or caught.
+ */
+static inline void e4c_record(unsigned char caught, const char *file,
+    int line) {
+    struct e4c_event *event = &exceptions4c.recorder.event[
+        exceptions4c.recorder.events++ % EXCEPTIONS4C_FLIGHT_RECORDER];
+    size_t length = 0;
+    while (length < EXCEPTION_EVENT_MESSAGE - 1
+        && EXCEPTION.message[length] != '\0') {
+        event->message[length] = EXCEPTION.message[length];
+        length++;
+    }
+    event->message[length] = '\0';
+    event->type = EXCEPTION.type;
+    event->name = EXCEPTION.name;
+    event->file = file;
+    event->line = line;
+    event->caught = caught;
+    event->depth = exceptions4c.blocks;
+    event->timestamp = EXCEPTIONS4C_TIMESTAMP;
+}
+
+/**
+ * @internal
+ * @brief Prints the events recorded by the flight recorder.
+ */
+static inline void e4c_print_history(void) {
+    unsigned long events = exceptions4c.recorder.events;
+    unsigned long first = events > EXCEPTIONS4C_FLIGHT_RECORDER
+        ? events - EXCEPTIONS4C_FLIGHT_RECORDER : 0;
+    exceptions4c.recorder.printed = events;
+    (void) fprintf(stderr, "\n[exceptions4c-lite]: Last %lu of %lu events:\n",
+        events - first, events);
+    for (; first < events; first++) {
+        const struct e4c_event *event =
+            &exceptions4c.recorder.event[first % EXCEPTIONS4C_FLIGHT_RECORDER];
+        (void) fprintf(stderr, "    #%lu %s %s: %s (depth %d, timestamp %llu)",
+            first, event->caught ? "caught" : "thrown", event->name,
+            event->message, (int) event->depth, event->timestamp);
+        if (event->file != NULL) {
+            (void) fprintf(stderr, " at %s:%d", event->file, event->line);
+        }
+        (void) fprintf(stderr, "\n");
+    }
+}
+
+/**
+ * Prints the events recorded by the flight recorder to standard error output.
+ *
+ * The last #EXCEPTIONS4C_FLIGHT_RECORDER exceptions thrown or caught by the
+ * current thread are printed, from the oldest to the newest, including their
+ * type, the beginning of their message, the location where they were thrown
+ * or caught, the number of nested #TRY blocks, and a timestamp.
+ *
+ * @pre
+ * This macro is only available if #EXCEPTIONS4C_FLIGHT_RECORDER is greater
+ * than zero.
+ *
+ * @see EXCEPTIONS4C_FLIGHT_RECORDER
+ */
+#define EXCEPTION_PRINT_HISTORY                                             \
+                                                                            \
+  e4c_print_history()
+
+/**
+ * @internal
+ * @brief Prints the events recorded by the flight recorder when the program
+ * aborts, unless they were printed already.
+ */
+static inline void e4c_abort_signal(int signal_number) {
+    (void) signal(signal_number, SIG_DFL);
+    if (exceptions4c.recorder.printed != exceptions4c.recorder.events) {
+        e4c_print_history();
+        (void) fflush(stderr);
+    }
+    (void) raise(signal_number);
+}
+
+/**
+ * Prints the events recorded by the flight recorder when the program aborts.
+ *
+ * This macro installs a handler for <tt>SIGABRT</tt> that prints the events
+ * recorded by the thread that aborts, unless nothing happened since they were
+ * last printed (for example, by the default #EXCEPTIONS4C_PANIC). Then the
+ * program aborts as usual.
+ *
+ * @pre
+ * This macro is only available if #EXCEPTIONS4C_FLIGHT_RECORDER is greater
+ * than zero.
+ *
+ * @attention
+ * The events are printed through <tt>stdio</tt>, which is not
+ * async-signal-safe. This is a best effort for crashes such as failed
+ * assertions.
+ *
+ * @return A truthy value if the handler was installed; a falsy value otherwise.
+ *
+ * @see EXCEPTION_PRINT_HISTORY
+ */
+#define EXCEPTION_PRINT_HISTORY_ON_ABORT                                    \
+                                                                            \
+  (signal(SIGABRT, e4c_abort_signal) != SIG_ERR)
+
+#endif
+
+#if EXCEPTIONS4C_LIVE_STATS > 0
+
+/**
+ * @internal
+ * @brief Starts writing the live statistics of the current thread.
+ */
+static inline void e4c_live_begin(struct e4c_live_thread *thread) {
+    atomic_store_explicit(&thread->sequence,
+        atomic_load_explicit(&thread->sequence, memory_order_relaxed) + 1,
+        memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+}
+
+/**
+ * @internal
+ * @brief Finishes writing the live statistics of the current thread.
+ */
+static inline void e4c_live_end(struct e4c_live_thread *thread) {
+    atomic_store_explicit(&thread->sequence,
+        atomic_load_explicit(&thread->sequence, memory_order_relaxed) + 1,
+        memory_order_release);
+}
+
+/**
+ * @internal
+ * @brief Copies the end of a string into live statistics.
+ */
+static inline void e4c_live_copy(char *target, const char *source,
+    size_t capacity) {
+    size_t length = source != NULL ? strlen(source) : 0;
+    if (length >= capacity) {
+        source += length - (capacity - 1);
+        length = capacity - 1;
+    }
+    if (length > 0) {
+        memcpy(target, source, length);
+    }
+    target[length] = '\0';
+}
+
+/**
+ * @internal
+ * @brief Returns the live statistics of the site that threw the current
+ * exception; or <tt>NULL</tt> if there is no room for them.
+ */
+static inline struct e4c_live_site *e4c_live_site(
+    struct e4c_live_thread *thread, const char *file, int line) {
+    size_t hash = ((size_t) EXCEPTION.name >> 3) ^ ((size_t) file >> 3)
+        ^ ((size_t) line * 2654435761UL);
+    size_t probe;
+    for (probe = 0; probe < EXCEPTIONS4C_LIVE_STATS; probe++) {
+        size_t index = (hash + probe) & (EXCEPTIONS4C_LIVE_STATS - 1);
+        struct e4c_live_key *key = &exceptions4c.live.key[index];
+        if (!key->used) {
+            key->used = 1;
+            key->name = EXCEPTION.name;
+            key->file = file;
+            key->line = line;
+            e4c_live_copy(thread->site[index].name, EXCEPTION.name,
+                EXCEPTION_LIVE_NAME);
+            e4c_live_copy(thread->site[index].file, file, EXCEPTION_LIVE_FILE);
+            thread->site[index].line = line;
+        }
+        if (key->name == EXCEPTION.name && key->file == file
+            && key->line == line) {
+            return &thread->site[index];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @internal
+ * @brief Publishes an exception thrown by the current thread.
+ */
+static inline void e4c_live_thrown(const char *file, int line) {
+    struct e4c_live_thread *thread = exceptions4c.live.thread;
+    struct e4c_live_site *site;
+    if (thread == NULL) {
+        return;
+    }
+    e4c_live_begin(thread);
+    thread->thrown++;
+    site = exceptions4c.live.current = e4c_live_site(thread, file, line);
+    if (site != NULL) {
+        site->thrown++;
+    } else {
+        thread->dropped++;
+    }
+    e4c_live_end(thread);
+}
+
+/**
+ * @internal
+ * @brief Publishes an exception caught by the current thread.
+ */
+static inline void e4c_live_caught(void) {
+    struct e4c_live_thread *thread = exceptions4c.live.thread;
+    if (thread == NULL) {
+        return;
+    }
+    e4c_live_begin(thread);
+    thread->caught++;
+    if (exceptions4c.live.current != NULL) {
+        exceptions4c.live.current->caught++;
+        exceptions4c.live.current = NULL;
+    }
+    e4c_live_end(thread);
+}
+
+/**
+ * @internal
+ * @brief Publishes an exception that terminated the program.
+ */
+static inline void e4c_live_terminated(void) {
+    struct e4c_live_thread *thread = exceptions4c.live.thread;
+    if (thread != NULL) {
+        e4c_live_begin(thread);
+        thread->terminated++;
+        e4c_live_end(thread);
+    }
+}
+
+/**
+ * @internal
+ * @brief Publishes the number of nested blocks of the current thread.
+ */
+static inline void e4c_live_depth(void) {
+    struct e4c_live_thread *thread = exceptions4c.live.thread;
+    if (thread == NULL) {
+        return;
+    }
+    atomic_store_explicit(&thread->depth, exceptions4c.blocks,
+        memory_order_relaxed);
+    if (EXCEPTIONS4C_UNLIKELY(
+        exceptions4c.blocks > exceptions4c.live.max_depth)) {
+        exceptions4c.live.max_depth = exceptions4c.blocks;
+        atomic_store_explicit(&thread->max_depth, exceptions4c.blocks,
+            memory_order_relaxed);
+    }
+}
+
+/**
+ * @internal
+ * @brief Publishes the number of nested blocks, if live statistics are
+ * enabled.
+ */
+#define EXCEPTION_LIVE_DEPTH                                                \
+                                                                            \
+  e4c_live_depth()
+
+#else
+
+/**
+ * @internal
+ * @brief Publishes the number of nested blocks, if live statistics are
+ * enabled.
+ */
+#define EXCEPTION_LIVE_DEPTH                                                \
+                                                                            \
+  ((void) 0)
+
+#endif
+
+/**
+ * @internal
+ * @brief Appends the current exception to a batch and skips the element that
+ * threw it.
+ *
+ * The state of the block is restored, just like when a #TRY block is left.
+ *
+ * This function is never inlined, so the batch escapes and is not kept in
+ * registers that would be restored by <tt>longjmp</tt>.
+ */
+static EXCEPTIONS4C_COLD void e4c_batch_fail(struct e4c_batch *batch) {
+    if (batch->failed < batch->capacity) {
+        batch->failure[batch->failed].index = EXCEPTION_BLOCK.index;
+        batch->failure[batch->failed].exception = EXCEPTION;
+    }
+    batch->failed++;
+#if EXCEPTIONS4C_FLIGHT_RECORDER > 0
+    e4c_record(1, NULL, 0);
+#endif
+#if EXCEPTIONS4C_LIVE_STATS > 0
+    e4c_live_caught();
+#endif
+    (void) EXCEPTION_BLOCK_LEAVE;
+    EXCEPTION_BLOCK.uncaught = 0;
+    EXCEPTION_BLOCK.index++;
+}
+
+/**
+ * @internal
+ * @brief Loads the first failure of a batch as the current exception.
+ */
+static inline int e4c_batch_aggregate(const struct e4c_batch *batch) {
+    const char *message;
+    size_t length;
+    if (batch->failed == 0 || batch->capacity == 0) {
+        return 0;
+    }
+    message = batch->failure[0].exception.message;
+    EXCEPTION = batch->failure[0].exception;
+    length = (size_t) snprintf(EXCEPTION.message, EXCEPTIONS4C_MAX_LENGTH,
+        "%lu elements failed; first at index %lu: ",
+        (unsigned long) batch->failed, (unsigned long) batch->failure[0].index);
+    while (length < EXCEPTIONS4C_MAX_LENGTH - 1 && *message != '\0') {
+        EXCEPTION.message[length++] = *message++;
+    }
+    if (length < EXCEPTIONS4C_MAX_LENGTH) {
+        EXCEPTION.message[length] = '\0';
+    }
+    return 1;
+}
+
+#if EXCEPTIONS4C_LOCKS > 0
+
+/**
+ * @internal
+ * @brief The lock is a mutex.
+ */
+#define EXCEPTION_LOCK_MUTEX 0
+
+/**
+ * @internal
+ * @brief The lock is a read-write lock, held for reading.
+ */
+#define EXCEPTION_LOCK_READ 1
+
+/**
+ * @internal
+ * @brief The lock is a read-write lock, held for writing.
+ */
+#define EXCEPTION_LOCK_WRITE 2
+
+#if EXCEPTIONS4C_LOCK_STATS > 0
+
+/**
+ * @internal
+ * @brief Returns the bucket of a histogram that counts a duration.
+ */
+static inline int e4c_lock_bucket(unsigned long long nanoseconds) {
+    int bucket = 0;
+    while (nanoseconds > 1 && bucket < EXCEPTION_LOCK_BUCKETS - 1) {
+        nanoseconds >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+#endif
+
+/**
+ * @internal
+ * @brief Releases the innermost lock held by a #LOCKED block.
+ */
+static inline void e4c_unlock(int unwound) {
+    struct e4c_held_lock *held =
+        &exceptions4c.locks.lock[--exceptions4c.locks.held];
+#if EXCEPTIONS4C_LOCK_STATS > 0
+    if (held->site != NULL) {
+        held->site->hold[e4c_lock_bucket(
+            EXCEPTIONS4C_LOCK_CLOCK - held->acquired)]++;
+        held->site->unwound += unwound;
+    }
+#endif
+    (void) unwound;
+    if (held->kind == EXCEPTION_LOCK_MUTEX) {
+        (void) pthread_mutex_unlock(held->lock);
+    } else {
+        (void) pthread_rwlock_unlock(held->lock);
+    }
+}
+
+#endif
+
+/**
+ * @internal
+ * @brief Transfers control to the innermost block that may handle the current
+ * exception.
+ *
+ * Blocks that published the types they catch (via #TRY_CATCHING) are searched
+ * first, and discarded without jumping into them if none of their types match.
+ * Blocks that didn't publish them are always jumped into. Locks acquired by
+ * #LOCKED blocks since the target block was entered are released right
+ * before jumping into it.
+ */
+EXCEPTIONS4C_RARE EXCEPTIONS4C_NORETURN
+void e4c_propagate(void) {
+    const e4c_exception_type *handles;
+    (void) EXCEPTION_SIGNAL_BUSY;
+    while (EXCEPTION_BLOCK_RANGE_CHECK
+        && (handles = EXCEPTION_BLOCK.handles) != NULL) {
+        while (*handles != NULL && *handles != EXCEPTION.type) {
+            handles++;
+        }
+        if (*handles != NULL) {
+            break;
+        }
+        (void) EXCEPTION_BLOCK_LEAVE;
+        exceptions4c.blocks--;
+    }
+    if (exceptions4c.blocks <= 0) {
+#if EXCEPTIONS4C_LIVE_STATS > 0
+        e4c_live_terminated();
+#endif
+        (void) (EXCEPTIONS4C_TERMINATE);
+        abort();
+    }
+#if EXCEPTIONS4C_LOCKS > 0
+    while (exceptions4c.locks.held > EXCEPTION_BLOCK.locks) {
+        e4c_unlock(1);
+    }
+#endif
+    (void) EXCEPTION_LIVE_DEPTH;
+    longjmp(EXCEPTION_BLOCK.jump, EXCEPTION_BLOCK.uncaught = 1);
+}
+
+/**
+ * @internal
+ * @brief Handles too many nested exception blocks.
+ */
+EXCEPTIONS4C_RARE EXCEPTIONS4C_NORETURN
+void e4c_panic(const char *file, int line) {
+    (void) file;
+    (void) line;
+    (void) (EXCEPTIONS4C_PANIC);
+    abort();
+}
+
+/**
+ * @internal
+ * @brief Throws the current exception again from the given location.
+ */
+EXCEPTIONS4C_RARE EXCEPTIONS4C_NORETURN
+void e4c_rethrow(const char *file, int line) {
+    (void) EXCEPTION_SIGNAL_BUSY;
+#ifndef NDEBUG
+    EXCEPTION.file = file;
+    EXCEPTION.line = line;
+#endif
+#if EXCEPTIONS4C_FLIGHT_RECORDER > 0
+    e4c_record(0, file, line);
+#endif
+#if EXCEPTIONS4C_LIVE_STATS > 0
+    e4c_live_thrown(file, line);
+#endif
+    (void) file;
+    (void) line;
+    e4c_propagate();
+}
+
+/**
+ * @internal
+ * @brief Throws an exception from the given location.
+ */
+EXCEPTIONS4C_RARE EXCEPTIONS4C_NORETURN
+void e4c_throw(e4c_exception_type type, const char *name,
+    const char *message, const char *file, int line) {
+    (void) EXCEPTION_SIGNAL_BUSY;
+#if EXCEPTIONS4C_RETRY
+    EXCEPTION.attempts = 0;
+#endif
+    EXCEPTION.type = type;
+    EXCEPTION.name = name;
+    (void) snprintf(EXCEPTION.message, (EXCEPTIONS4C_MAX_LENGTH), "%s",
+        message ? message : type);
+    e4c_rethrow(file, line);
+}
+
+/**
+ * @internal
+ * @brief Throws an exception with a formatted message from the given
+ * location.
+ */
+EXCEPTIONS4C_RARE EXCEPTIONS4C_NORETURN
+void e4c_throwf(e4c_exception_type type, const char *name,
+    const char *file, int line, const char *format, ...) {
+    va_list arguments;
+    (void) EXCEPTION_SIGNAL_BUSY;
+#if EXCEPTIONS4C_RETRY
+    EXCEPTION.attempts = 0;
+#endif
+    EXCEPTION.type = type;
+    EXCEPTION.name = name;
+    va_start(arguments, format);
+    (void) vsnprintf(EXCEPTION.message, (EXCEPTIONS4C_MAX_LENGTH), format,
+        arguments);
+    va_end(arguments);
+    e4c_rethrow(file, line);
+}
+
+/**
+ * @internal
+ * @brief Enters a new exception block.
+ */
+static inline void e4c_enter(const e4c_exception_type *handles,
+    const char *file, int line) {
+    (void) EXCEPTION_SIGNAL_BUSY;
+    if (EXCEPTIONS4C_UNLIKELY(
+        exceptions4c.blocks >= EXCEPTIONS4C_MAX_BLOCKS)) {
+        e4c_panic(file, line);
+    }
+    exceptions4c.blocks++;
+    EXCEPTION_BLOCK.stage = EXCEPTION_BLOCK.uncaught = 0;
+    EXCEPTION_BLOCK.handles = handles;
+    (void) EXCEPTION_BLOCK_ENTER;
+    (void) EXCEPTION_LIVE_DEPTH;
+}
+
+/**
+ * @internal
+ * @brief Leaves the current exception block, propagating its exception if it
+ * was not caught.
+ */
+static inline int e4c_leave(void) {
+    (void) EXCEPTION_SIGNAL_BUSY;
+    (void) EXCEPTION_BLOCK_LEAVE;
+    if (exceptions4c.block[--exceptions4c.blocks].uncaught) {
+        e4c_propagate();
+    }
+    (void) EXCEPTION_LIVE_DEPTH;
+    (void) EXCEPTION_SIGNAL_IDLE;
+    return 0;
+}
+
+/**
+ * @internal
+ * @brief Advances the current exception block to its next stage, or leaves it
+ * after the last one.
+ */
+static inline int e4c_next(int stages) {
+    (void) EXCEPTION_SIGNAL_IDLE;
+    return EXCEPTION_BLOCK_RANGE_CHECK
+        && (++EXCEPTION_BLOCK.stage < stages || e4c_leave());
+}
+
+/**
+ * @internal
+ * @brief Determines whether the current exception block is in a given stage.
+ *
+ * The range of the current block was already checked by #e4c_next.
+ */
+static inline int e4c_stage(int stage) {
+    return EXCEPTION_BLOCK.stage == stage;
+}
+
+/**
+ * @internal
+ * @brief Determines whether the current exception block is in a given stage,
+ * and whether it has cleanup to run.
+ *
+ * Blocks introduced by #TRY_CATCHING visit their handlers in stage zero. If
+ * they have cleanup to run, they stop publishing the types they catch, so
+ * that exceptions of any type jump into them.
+ */
+static inline int e4c_cleanup(int stage) {
+    if (EXCEPTIONS4C_UNLIKELY(EXCEPTION_BLOCK.stage == 0)) {
+        EXCEPTION_BLOCK.handles = NULL;
+    }
+    return EXCEPTION_BLOCK.stage == stage;
+}
+
+/**
+ * @internal
+ * @brief Catches the current exception if it is of the given type.
+ */
+EXCEPTIONS4C_RARE int e4c_catch(e4c_exception_type type, const char *file,
+    int line) {
+    if (!EXCEPTION_BLOCK.uncaught || EXCEPTION_BLOCK.stage != 2
+        || type != EXCEPTION.type) {
+        return 0;
+    }
+    EXCEPTION_BLOCK.uncaught = 0;
+#if EXCEPTIONS4C_FLIGHT_RECORDER > 0
+    e4c_record(1, file, line);
+#endif
+#if EXCEPTIONS4C_LIVE_STATS > 0
+    e4c_live_caught();
+#endif
+    (void) file;
+    (void) line;
+    return 1;
+}
+
+#if EXCEPTIONS4C_RETRY
+
+/**
+ * @internal
+ * @brief Returns the delay before the next attempt of a #RETRY block.
+ */
+static inline unsigned long e4c_backoff(const struct e4c_retry_policy *policy,
+    int attempt) {
+    unsigned long delay = policy->delay;
+    if (policy->backoff == BACKOFF_NONE) {
+        return 0;
+    }
+    if (policy->backoff == BACKOFF_EXPONENTIAL) {
+        unsigned long long *random = &exceptions4c.retry.random;
+        while (--attempt > 0 && delay < (~0UL >> 1)
+            && (policy->max_delay == 0 || delay < policy->max_delay)) {
+            delay *= 2;
+        }
+        if (policy->max_delay > 0 && delay > policy->max_delay) {
+            delay = policy->max_delay;
+        }
+        if (*random == 0) {
+            *random = 0x9E3779B97F4A7C15ULL;
+        }
+        *random ^= *random << 13;
+        *random ^= *random >> 7;
+        *random ^= *random << 17;
+        return delay / 2 + (unsigned long) (*random % (delay / 2 + 1));
+    }
+    return policy->max_delay > 0 && delay > policy->max_delay
+        ? policy->max_delay : delay;
+}
+
+/**
+ * @internal
+ * @brief Prepares the next attempt of a #RETRY block, or propagates the
+ * current exception after the last one.
+ */
+static EXCEPTIONS4C_COLD void e4c_retry(int max_attempts) {
+    const struct e4c_retry_policy *policy = exceptions4c.retry.policy;
+    int attempt = (int) EXCEPTION_BLOCK.index;
+    unsigned long delay = 0;
+    EXCEPTION.attempts = attempt;
+    if (policy != NULL && attempt < max_attempts) {
+        delay = e4c_backoff(policy, attempt);
+    }
+    if (policy != NULL && policy->on_attempt != NULL) {
+        policy->on_attempt(attempt, delay, &EXCEPTION);
+    }
+    if (attempt >= max_attempts) {
+        (void) e4c_leave();
+    }
+    if (delay > 0) {
+        EXCEPTIONS4C_SLEEP(delay);
+    }
+    (void) EXCEPTION_ARENA_LEAVE;
+    EXCEPTION_BLOCK.index++;
+    EXCEPTION_BLOCK.stage = EXCEPTION_BLOCK.uncaught = 0;
+}
+
+#endif
+
+#if EXCEPTIONS4C_ARENA_SIZE > 0
+
+/**
+ * @internal
+ * @brief Allocates memory from the scoped arena.
+ */
+static inline void *e4c_arena_alloc(size_t size) {
+    size_t units = size / sizeof(union e4c_arena_unit)
+        + (size % sizeof(union e4c_arena_unit) != 0);
+    void *memory;
+    if (size == 0 || units > EXCEPTION_ARENA_UNITS - exceptions4c.arena.used) {
+        return NULL;
+    }
+    memory = &exceptions4c.arena.memory[exceptions4c.arena.used];
+    exceptions4c.arena.used += units;
+    return memory;
+}
+
+/**
+ * Allocates memory whose lifetime is bound to the current #TRY block.
+ *
+ * Allocations are pointer bumps from a fixed region preallocated inside the
+ * [global variable](#exceptions4c) that contains the current status of
+ * exceptions. When the current #TRY block is exited, either normally or
+ * because an exception is propagating through it, everything allocated inside
+ * it is released at once.
+ *
+ * @pre
+ * This macro is only available if #EXCEPTIONS4C_ARENA_SIZE is greater than
+ * zero.
+ *
+ * @attention
+ * The memory MUST NOT be used after the enclosing #TRY block is exited, and it
+ * MUST NOT be passed to <tt>free</tt>. Memory allocated outside of any #TRY
+ * block is never released.
+ *
+ * @param size The number of bytes to allocate.
+ * @return A pointer to the allocated memory, suitably aligned for any type; or
+ *   <tt>NULL</tt> if the arena is exhausted or <tt>size</tt> is zero.
+ *
+ * @see EXCEPTIONS4C_ARENA_SIZE
+ * @see TRY
+ */
+#define ARENA_ALLOC(size)                                                   \
+                                                                            \
+  e4c_arena_alloc(size)
+
+#endif
+
+#if EXCEPTIONS4C_CANCELLATION
+
+/**
+ * Represents a request to cancel a thread.
+ *
+ * A thread MAY obtain its own token through #CANCELLATION_TOKEN and hand it
+ * over to any other thread that might need to #CANCEL it.
+ *
+ * @pre
+ * This type is only available if #EXCEPTIONS4C_CANCELLATION is nonzero.
+ *
+ * @see CANCEL
+ * @see CHECKPOINT
+ */
+typedef atomic_int *e4c_cancellation_token;
+
+/**
+ * The type of exception thrown by a #CHECKPOINT when the current thread has
+ * been cancelled.
+ *
+ * You MUST define this exception type for your program.
+ *
+ * ```c
+ * const e4c_exception_type CANCELLED = "Cancelled";
+ * ```
+ *
+ * @pre
+ * This exception type is only available if #EXCEPTIONS4C_CANCELLATION is
+ * nonzero.
+ *
+ * @see CHECKPOINT
+ */
+extern const e4c_exception_type CANCELLED;
+
+/**
+ * Retrieves the cancellation token of the current thread.
+ *
+ * @pre
+ * This macro is only available if #EXCEPTIONS4C_CANCELLATION is nonzero.
+ *
+ * @return The token that other threads MAY use to #CANCEL the current thread.
+ *
+ * @see CANCEL
+ */
+#define CANCELLATION_TOKEN                                                  \
+                                                                            \
+  ((e4c_cancellation_token) &exceptions4c.cancelled)
+
+/**
+ * Requests the cancellation of a thread.
+ *
+ * This macro MAY be used from any thread. It returns immediately; the target
+ * thread will #THROW a #CANCELLED exception the next time it reaches a
+ * #CHECKPOINT.
+ *
+ * @pre
+ * This macro is only available if #EXCEPTIONS4C_CANCELLATION is nonzero.
+ *
+ * @param token The cancellation token of the thread to cancel.
+ *
+ * @see CANCELLATION_TOKEN
+ * @see CHECKPOINT
+ */
+#define CANCEL(token)                                                       \
+                                                                            \
+  atomic_store_explicit((token), 1, memory_order_relaxed)
+
+/**
+ * @internal
+ * @brief Throws a #CANCELLED exception if the current thread has been
+ * cancelled.
+ */
+#define EXCEPTION_CHECK_CANCELLED                                           \
+                                                                            \
+  (EXCEPTIONS4C_UNLIKELY(atomic_load_explicit(&exceptions4c.cancelled,      \
+    memory_order_relaxed))                                                  \
+      ? (atomic_store_explicit(&exceptions4c.cancelled, 0,                  \
+        memory_order_relaxed), THROW(CANCELLED, NULL))                      \
+      : (void) 0)
+
+#else
+
+/**
+ * @internal
+ * @brief Throws a #CANCELLED exception if the current thread has been
+ * cancelled.
+ */
+#define EXCEPTION_CHECK_CANCELLED                                           \
+                                                                            \
+  ((void) 0)
+
+#endif
+
+#if EXCEPTIONS4C_DEADLINES
+
+/**
+ * The type of exception thrown by a #CHECKPOINT when the deadline of the
+ * current #TRY_WITHIN block has passed.
+ *
+ * You MUST define this exception type for your program.
+ *
+ * ```c
+ * const e4c_exception_type TIMEOUT = "Timeout";
+ * ```
+ *
+ * @pre
+ * This exception type is only available if #EXCEPTIONS4C_DEADLINES is
+ * nonzero.
+ *
+ * @see TRY_WITHIN
+ */
+extern const e4c_exception_type TIMEOUT;
+
+/**
+ * @internal
+ * @brief Sets the deadline of the current block, unless the outer deadline is
+ * tighter.
+ */
+static inline void e4c_deadline(unsigned long long budget) {
+    unsigned long long deadline = EXCEPTIONS4C_CLOCK + budget;
+    if (exceptions4c.deadline == 0 || deadline < exceptions4c.deadline) {
+        exceptions4c.deadline = deadline;
+    }
+}
+
+/**
+ * @internal
+ * @brief Disarms the deadline of the current block before throwing a
+ * #TIMEOUT exception.
+ *
+ * The nested blocks entered since the deadline was set saved it too, and they
+ * would restore it when the exception leaves them. So every saved deadline
+ * that has passed as well is disarmed. Only async-signal-safe code is run.
+ */
+static inline void e4c_deadline_expired(void) {
+    unsigned long long deadline = exceptions4c.deadline;
+    int index;
+    for (index = 0; index < exceptions4c.blocks
+        && index < EXCEPTIONS4C_MAX_BLOCKS; index++) {
+        if (exceptions4c.block[index].deadline <= deadline) {
+            exceptions4c.block[index].deadline = 0;
+        }
+    }
+    exceptions4c.deadline = 0;
+}
+
+/**
+ * @internal
+ * @brief Throws a #TIMEOUT exception if the deadline of the current block has
+ * passed.
+ */
+#define EXCEPTION_CHECK_DEADLINE                                            \
+                                                                            \
+  (EXCEPTIONS4C_UNLIKELY(exceptions4c.deadline != 0                         \
+    && EXCEPTIONS4C_CLOCK >= exceptions4c.deadline)                         \
+      ? (e4c_deadline_expired(), THROW(TIMEOUT, NULL))                      \
+      : (void) 0)
+
+#else
+
+/**
+ * @internal
+ * @brief Throws a #TIMEOUT exception if the deadline of the current block has
+ * passed.
+ */
+#define EXCEPTION_CHECK_DEADLINE                                            \
+                                                                            \
+  ((void) 0)
+
+#endif
+
+#if EXCEPTIONS4C_CANCELLATION || EXCEPTIONS4C_DEADLINES
+
+/**
+ * Throws an exception if the current thread has been cancelled, or if the
+ * deadline of the current #TRY_WITHIN block has passed.
+ *
+ * Long-running code SHOULD reach this macro periodically so that it can be
+ * cancelled by other threads, or interrupted when it runs out of time.
+ *
+ * When the thread has not been cancelled, checking for cancellation costs a
+ * single relaxed atomic load. The cancellation request is consumed when the
+ * #CANCELLED exception is thrown, so that the thread MAY be reused after
+ * handling it.
+ *
+ * When no #TRY_WITHIN block is active, checking for deadlines costs a single
+ * comparison. Otherwise, the monotonic #EXCEPTIONS4C_CLOCK is read.
+ *
+ * @pre
+ * This macro is only available if #EXCEPTIONS4C_CANCELLATION or
+ * #EXCEPTIONS4C_DEADLINES is nonzero.
+ *
+ * @see CANCEL
+ * @see CANCELLED
+ * @see TRY_WITHIN
+ * @see TIMEOUT
+ */
+#define CHECKPOINT()                                                        \
+                                                                            \
+  ((void) EXCEPTION_CHECK_CANCELLED, (void) EXCEPTION_CHECK_DEADLINE)
+
+#endif
+
+#if EXCEPTIONS4C_DEADLINES && EXCEPTIONS4C_DEADLINE_SIGNAL
+
+/**
+ * @internal
+ * @brief Throws a #TIMEOUT exception from a signal handler, if the deadline
+ * of the current block has passed.
+ *
+ * Only async-signal-safe functions are called before jumping. Nothing is
+ * thrown while the library is busy entering, leaving or propagating through
+ * a block, since the jump buffer of the current block MAY not be armed yet.
+ * The location where the exception was thrown is unknown, so it is left
+ * empty.
+ */
+static void e4c_deadline_signal(int signal_number) {
+    sigset_t signals;
+    size_t length = 0;
+    if (exceptions4c.busy || exceptions4c.deadline == 0
+        || EXCEPTIONS4C_CLOCK < exceptions4c.deadline
+        || exceptions4c.blocks <= 0) {
+        return;
+    }
+    e4c_deadline_expired();
+    (void) sigemptyset(&signals);
+    (void) sigaddset(&signals, signal_number);
+    (void) sigprocmask(SIG_UNBLOCK, &signals, NULL);
+    EXCEPTION.type = TIMEOUT;
+    EXCEPTION.name = "TIMEOUT";
+    while (TIMEOUT[length] != '\0' && length < EXCEPTIONS4C_MAX_LENGTH - 1) {
+        EXCEPTION.message[length] = TIMEOUT[length];
+        length++;
+    }
+    EXCEPTION.message[length] = '\0';
+#ifndef NDEBUG
+    EXCEPTION.file = NULL;
+    EXCEPTION.line = 0;
+#endif
+    e4c_propagate();
+}
+
+/**
+ * @internal
+ * @brief Starts the timer that checks for expired deadlines periodically.
+ */
+static inline int e4c_deadline_timer(unsigned long interval) {
+    struct sigaction action = {0};
+    struct itimerval timer = {0};
+    action.sa_handler = e4c_deadline_signal;
+    (void) sigemptyset(&action.sa_mask);
+    timer.it_interval.tv_sec = (time_t) (interval / 1000);
+    timer.it_interval.tv_usec = (suseconds_t) (interval % 1000 * 1000);
+    timer.it_value = timer.it_interval;
+    return sigaction(EXCEPTIONS4C_DEADLINE_SIGNAL, &action, NULL) == 0
+        && setitimer(ITIMER_REAL, &timer, NULL) == 0;
+}
+
+/**
+ * Starts a timer that interrupts #TRY_WITHIN blocks whose deadline has
+ * passed, even if their body doesn't reach any #CHECKPOINT.
+ *
+ * Every <tt>interval</tt> milliseconds, the #EXCEPTIONS4C_DEADLINE_SIGNAL is
+ * raised and, if the deadline of the current #TRY_WITHIN block has passed, a
+ * #TIMEOUT exception is thrown from the signal handler.
+ *
+ * @pre
+ * This macro is only available if both #EXCEPTIONS4C_DEADLINES and
+ * #EXCEPTIONS4C_DEADLINE_SIGNAL are nonzero.
+ *
+ * @attention
+ * The body of the #TRY_WITHIN blocks MUST only call async-signal-safe
+ * functions. A zero interval stops the timer.
+ *
+ * @param interval The number of milliseconds between checks.
+ * @return A truthy value if the timer was started; a falsy value otherwise.
+ *
+ * @see EXCEPTIONS4C_DEADLINE_SIGNAL
+ * @see TRY_WITHIN
+ */
+#define DEADLINE_TIMER(interval)                                            \
+                                                                            \
+  e4c_deadline_timer(interval)
+
+#endif
+
+#if EXCEPTIONS4C_FAULT_INJECTION
+
+/**
+ * @internal
+ * @brief Determines whether a string matches a pattern of the given length,
+ * either exactly or as a suffix.
+ */
+static inline int e4c_fault_match(const char *string, const char *pattern,
+    size_t length, int suffix) {
+    size_t string_length = 0;
+    while (string[string_length] != '\0') {
+        string_length++;
+    }
+    if (string_length < length || (!suffix && string_length != length)) {
+        return 0;
+    }
+    string += string_length - length;
+    while (length > 0 && *string == *pattern) {
+        string++, pattern++, length--;
+    }
+    return length == 0;
+}
+
+/**
+ * @internal
+ * @brief Determines whether a fault is injected at a throw site.
+ */
+static EXCEPTIONS4C_COLD int e4c_fault(const char *name, const char *file,
+    int line) {
+    struct e4c_faults *faults = &exceptions4c.faults;
+    if (faults->type != NULL
+        && !e4c_fault_match(name, faults->type, faults->type_length, 0)) {
+        return 0;
+    }
+    if (faults->file != NULL
+        && (!e4c_fault_match(file, faults->file, faults->file_length, 1)
+            || (faults->line > 0 && faults->line != line))) {
+        return 0;
+    }
+    if (faults->every > 0) {
+        if (++faults->calls % faults->every != 0) {
+            return 0;
+        }
+    } else {
+        /* xorshift64* */
+        faults->random ^= faults->random >> 12;
+        faults->random ^= faults->random << 25;
+        faults->random ^= faults->random >> 27;
+        if (((faults->random * 0x2545F4914F6CDD1DULL) >> 32)
+            >= faults->threshold) {
+            return 0;
+        }
+    }
+    faults->injected++;
+    return 1;
+}
+
+/**
+ * @internal
+ * @brief Configures fault injection for the current thread.
+ */
+static inline int e4c_inject_faults(const char *spec) {
+    struct e4c_faults faults = {0};
+    faults.random = 0x9E3779B97F4A7C15ULL;
+    if (spec == NULL) {
+        spec = getenv("EXCEPTIONS4C_FAULTS");
+    }
+    while (spec != NULL && *spec != '\0') {
+        const char *value = spec;
+        const char *next;
+        char *end;
+        size_t key;
+        while (*value != '=' && *value != ',' && *value != '\0') {
+            value++;
+        }
+        if (*value != '=') {
+            return 0;
+        }
+        key = (size_t) (value++ - spec);
+        for (next = value; *next != ',' && *next != '\0'; next++) {
+            /* find the end of the value */
+        }
+        if (e4c_fault_match("type", spec, key, 0)) {
+            faults.type = value;
+            faults.type_length = (size_t) (next - value);
+        } else if (e4c_fault_match("site", spec, key, 0)) {
+            const char *colon = next;
+            while (colon > value && colon[-1] >= '0' && colon[-1] <= '9') {
+                colon--;
+            }
+            if (colon > value && colon < next && colon[-1] == ':') {
+                faults.line = (int) strtol(colon, NULL, 10);
+                colon--;
+            } else {
+                colon = next;
+            }
+            faults.file = value;
+            faults.file_length = (size_t) (colon - value);
+        } else if (e4c_fault_match("probability", spec, key, 0)) {
+            double probability = strtod(value, &end);
+            if (end != next || probability < 0 || probability > 1) {
+                return 0;
+            }
+            faults.threshold =
+                (unsigned long long) (probability * 4294967296.0);
+        } else if (e4c_fault_match("every", spec, key, 0)) {
+            faults.every = strtoul(value, &end, 10);
+            if (end != next) {
+                return 0;
+            }
+        } else if (e4c_fault_match("seed", spec, key, 0)) {
+            faults.random = strtoull(value, &end, 10);
+            if (end != next || faults.random == 0) {
+                return 0;
+            }
+        } else {
+            return 0;
+        }
+        spec = *next == ',' ? next + 1 : next;
+    }
+    faults.active = faults.every > 0 || faults.threshold > 0;
+    exceptions4c.faults = faults;
+    return 1;
+}
+
+/**
+ * Configures the faults injected by the current thread.
+ *
+ * The specification is a comma-separated list of <tt>key=value</tt> pairs:
+ *
+ * - <tt>type=NAME</tt>: only inject faults of the exception type named
+ *   <tt>NAME</tt>.
+ * - <tt>site=FILE:LINE</tt>: only inject faults at fault points located in a
+ *   source file whose path ends with <tt>FILE</tt> (and, optionally, at the
+ *   given line).
+ * - <tt>probability=P</tt>: inject faults with probability <tt>P</tt>, between
+ *   <tt>0</tt> and <tt>1</tt>.
+ * - <tt>every=N</tt>: inject a fault every <tt>N</tt>th time a matching fault
+ *   point is reached, instead of randomly.
+ * - <tt>seed=S</tt>: seed the pseudo-random number generator with a nonzero
+ *   value, so that runs are reproducible.
+ *
+ * Each thread has its own configuration and pseudo-random number generator,
+ * provided the [global variable](#exceptions4c) is
+ * #EXCEPTIONS4C_THREAD_LOCAL. An empty specification disables fault
+ * injection.
+ *
+ * Example:
+ * ```c
+ * INJECT_FAULTS("type=IO_ERROR,probability=0.01,seed=42");
+ * ```
+ *
+ * @pre
+ * This macro is only available if #EXCEPTIONS4C_FAULT_INJECTION is nonzero.
+ *
+ * @attention
+ * The specification string MUST outlive the configuration, since type names
+ * and file names are not copied.
+ *
+ * @param spec The specification of the faults to inject; if <tt>NULL</tt>,
+ *   the value of the environment variable <tt>EXCEPTIONS4C_FAULTS</tt> is used.
+ * @return A truthy value if the specification was valid; a falsy value
+ *   otherwise, in which case the previous configuration is kept.
+ *
+ * @see FAULT_INJECTED
+ */
+#define INJECT_FAULTS(spec)                                                 \
+                                                                            \
+  e4c_inject_faults(spec)
+
+/**
+ * Determines whether a fault of the given type is injected at this point.
+ *
+ * Fault points SHOULD be placed next to real throw sites, so that injected
+ * faults exercise the same error path as real ones.
+ *
+ * When #EXCEPTIONS4C_FAULT_INJECTION is zero, this macro evaluates to a falsy
+ * constant. Otherwise, it costs a single predictable branch until faults are
+ * configured via #INJECT_FAULTS.
+ *
+ * Example:
+ * ```c
+ * if (read(fd, buffer, size) < 0 || FAULT_INJECTED(IO_ERROR)) {
+ *   THROW(IO_ERROR, "Could not read");
+ * }
+ * ```
+ *
+ * @param type The type of the exception thrown at this point.
+ * @return A truthy value if a fault was injected; a falsy value otherwise.
+ *
+ * @see EXCEPTIONS4C_FAULT_INJECTION
+ * @see INJECT_FAULTS
+ */
+#define FAULT_INJECTED(type)                                                \
+                                                                            \
+  (EXCEPTIONS4C_UNLIKELY(exceptions4c.faults.active)                        \
+    && e4c_fault(#type, __FILE__, __LINE__))
+
+#else
+
+/**
+ * Determines whether a fault of the given type is injected at this point.
+ *
+ * @param type The type of the exception thrown at this point.
+ * @return A falsy value, since #EXCEPTIONS4C_FAULT_INJECTION is zero.
+ */
+#define FAULT_INJECTED(type)                                                \
+                                                                            \
+  0
+
+#endif
+
+#if EXCEPTIONS4C_LOCKS > 0
+
+#if EXCEPTIONS4C_LOCK_STATS > 0
+
+/**
+ * @internal
+ * @brief Returns the location of a #LOCKED block, even if <tt>NDEBUG</tt> is
+ * defined, so that its statistics can be told apart.
+ */
+#define EXCEPTION_LOCK_SITE                                                 \
+                                                                            \
+  __FILE__, __LINE__
+
+/**
+ * @internal
+ * @brief Returns the current time, if lock statistics are enabled.
+ */
+#define EXCEPTION_LOCK_NOW                                                  \
+                                                                            \
+  EXCEPTIONS4C_LOCK_CLOCK
+
+#else
+
+/**
+ * @internal
+ * @brief Returns the location of a #LOCKED block.
+ */
+#define EXCEPTION_LOCK_SITE                                                 \
+                                                                            \
+  EXCEPTION_SITE
+
+/**
+ * @internal
+ * @brief Returns the current time, if lock statistics are enabled.
+ */
+#define EXCEPTION_LOCK_NOW                                                  \
+                                                                            \
+  0ULL
+
+#endif
+
+/**
+ * @internal
+ * @brief Handles a lock that could not be acquired.
+ */
+static EXCEPTIONS4C_COLD EXCEPTIONS4C_NORETURN
+void e4c_lock_failed(const char *file, int line) {
+    (void) fprintf(stderr, "\n[exceptions4c-lite]: Could not acquire lock.\n");
+    if (file != NULL) {
+        (void) fprintf(stderr, "    at %s:%d\n", file, line);
+    }
+    (void) EXCEPTION_DUMP;
+    (void) fflush(stderr);
+    abort();
+}
+
+/**
+ * @internal
+ * @brief Makes room for one more held lock, and returns the time the lock is
+ * requested.
+ */
+static inline unsigned long long e4c_lock_begin(const char *file, int line) {
+    if (EXCEPTIONS4C_UNLIKELY(exceptions4c.locks.held >= EXCEPTIONS4C_LOCKS)) {
+        e4c_lock_failed(file, line);
+    }
+    return EXCEPTION_LOCK_NOW;
+}
+
+#if EXCEPTIONS4C_LOCK_STATS > 0
+
+/**
+ * @internal
+ * @brief Returns the statistics of a #LOCKED block; or <tt>NULL</tt> if there
+ * is no room for them.
+ */
+static inline struct e4c_lock_site *e4c_lock_site(const char *file,
+    int line) {
+    size_t hash = ((size_t) file >> 3) ^ ((size_t) line * 2654435761UL);
+    size_t probe;
+    for (probe = 0; probe < EXCEPTIONS4C_LOCK_STATS; probe++) {
+        struct e4c_lock_site *site = &exceptions4c.locks.site[
+            (hash + probe) & (EXCEPTIONS4C_LOCK_STATS - 1)];
+        if (site->file == NULL) {
+            site->file = file;
+            site->line = line;
+        }
+        if (site->file == file && site->line == line) {
+            return site;
+        }
+    }
+    return NULL;
+}
+
+#endif
+
+/**
+ * @internal
+ * @brief Pushes a lock that was just acquired.
+ */
+static inline void e4c_lock_push(void *lock, unsigned char kind,
+    unsigned long long requested, const char *file, int line) {
+    struct e4c_held_lock *held =
+        &exceptions4c.locks.lock[exceptions4c.locks.held++];
+    held->lock = lock;
+    held->kind = kind;
+    held->running = 0;
+#if EXCEPTIONS4C_LOCK_STATS > 0
+    held->acquired = EXCEPTIONS4C_LOCK_CLOCK;
+    held->site = e4c_lock_site(file, line);
+    if (held->site != NULL) {
+        held->site->acquired++;
+        held->site->wait[e4c_lock_bucket(held->acquired - requested)]++;
+    }
+#endif
+    (void) requested;
+    (void) file;
+    (void) line;
+}
+
+/**
+ * @internal
+ * @brief Acquires a mutex for a #LOCKED block.
+ */
+static inline void e4c_lock_mutex(pthread_mutex_t *mutex, const char *file,
+    int line) {
+    unsigned long long requested = e4c_lock_begin(file, line);
+    if (EXCEPTIONS4C_UNLIKELY(pthread_mutex_lock(mutex) != 0)) {
+        e4c_lock_failed(file, line);
+    }
+    e4c_lock_push(mutex, EXCEPTION_LOCK_MUTEX, requested, file, line);
+}
+
+/**
+ * @internal
+ * @brief Acquires a read-write lock for a #READ_LOCKED or #WRITE_LOCKED
+ * block.
+ */
+static inline void e4c_lock_rwlock(pthread_rwlock_t *rwlock,
+    unsigned char kind, const char *file, int line) {
+    unsigned long long requested = e4c_lock_begin(file, line);
+    int error = kind == EXCEPTION_LOCK_READ
+        ? pthread_rwlock_rdlock(rwlock) : pthread_rwlock_wrlock(rwlock);
+    if (EXCEPTIONS4C_UNLIKELY(error != 0)) {
+        e4c_lock_failed(file, line);
+    }
+    e4c_lock_push(rwlock, kind, requested, file, line);
+}
+
 /**
  * @internal
- * @brief Propagates the current exception to the outer exception block.
+ * @brief Runs the body of the innermost #LOCKED block once, and then releases
+ * its lock.
  */
-#define EXCEPTION_PROPAGATE                                                 \
-                                                                            \
-  longjmp(EXCEPTION_BLOCK.jump, EXCEPTION_BLOCK.uncaught = 1)
+static inline int e4c_locked(void) {
+    struct e4c_held_lock *held =
+        &exceptions4c.locks.lock[exceptions4c.locks.held - 1];
+    if (!held->running) {
+        held->running = 1;
+        return 1;
+    }
+    e4c_unlock(0);
+    return 0;
+}
 
 /**
- * Contains the current status of exceptions.
+ * Introduces a block of code that holds a mutex.
  *
- * You MUST define this global variable for your program.
+ * The mutex is acquired before the block is executed, and released after it
+ * completes, either normally or because an exception propagates out of it.
+ * There is no need to wrap it in a #TRY block with a #FINALLY clause.
  *
+ * Example:
  * ```c
- * struct e4c_context exceptions4c = {0};
+ * LOCKED (&accounts_mutex) {
+ *   withdraw(account, amount);
+ * }
  * ```
- */
-extern struct e4c_context exceptions4c;
-
-/**
- * Introduces a block of code that may throw exceptions during execution.
  *
- * The #TRY block is used to define a section of code where exceptions MAY
- * occur. It allows you to handle exceptions gracefully using other blocks that
- * follow it. If an exception occurs, control is transferred to the appropriate
- * block.
+ * If the mutex cannot be acquired, or more than #EXCEPTIONS4C_LOCKS locks are
+ * held at once, the program is aborted.
  *
- * A single #TRY block MAY be followed by:
- *
- * 1. One or more #CATCH blocks to handle specific types of exceptions.
- * 2. Optionally, one #CATCH_ALL block to handle all exception types (if
- *    present, it MUST appear after all #CATCH blocks).
- * 3. Optionally, one #FINALLY block to execute cleanup code, regardless of
- *    whether an exception was thrown or caught.
+ * @pre
+ * This macro is only available if #EXCEPTIONS4C_LOCKS is greater than zero.
  *
  * @attention
- * These blocks MUST NOT be exited through any of: <tt>goto</tt>,
- * <tt>break</tt>, <tt>continue</tt>, or <tt>return</tt>.
- *
- * @important
- * Local variables in the function containing the #TRY block MUST be
- * <tt>volatile</tt> because these blocks invoke <tt>setjump</tt> and their
- * values would be indeterminate if they had been changed since the invocation.
+ * The block MUST NOT be exited via <tt>break</tt>, <tt>return</tt>,
+ * <tt>goto</tt> or <tt>longjmp</tt>, since the mutex would not be released.
  *
- * Example: @snippet pet-store.c try
+ * @param mutex A pointer to the <tt>pthread_mutex_t</tt> to hold.
  *
- * @see CATCH
- * @see CATCH_ALL
- * @see FINALLY
+ * @see READ_LOCKED
+ * @see WRITE_LOCKED
+ * @see EXCEPTIONS4C_LOCKS
  */
-#define TRY                                                                 \
-                                                                            \
-  for (                                                                     \
-    (void) (exceptions4c.blocks >= EXCEPTIONS4C_MAX_BLOCKS                  \
-      && ((void) (EXCEPTIONS4C_PANIC), 0)),                                 \
-    exceptions4c.blocks++,                                                  \
-    EXCEPTION_BLOCK.stage = EXCEPTION_BLOCK.uncaught = 0,                   \
-    (void) setjmp(EXCEPTION_BLOCK.jump);                                    \
+#define LOCKED(mutex)                                                       \
                                                                             \
-    EXCEPTION_BLOCK_RANGE_CHECK && (++EXCEPTION_BLOCK.stage < 4             \
-      || (exceptions4c.block[--exceptions4c.blocks].uncaught                \
-        && ((void) (exceptions4c.blocks > 0 && (EXCEPTION_PROPAGATE, 0)),   \
-          (void) (EXCEPTIONS4C_TERMINATE), 0)));                            \
-  )                                                                         \
-    if (EXCEPTION_BLOCK.stage == 1)
+  for (e4c_lock_mutex((mutex), EXCEPTION_LOCK_SITE); e4c_locked(); )
 
 /**
- * Introduces a block of code that handles exceptions thrown by a preceding #TRY
- * block.
- *
- * Use this macro to to handle a specific type of exceptions when they occur.
- *
- * If <tt>type</tt> is equal to the type of the [thrown exception](#EXCEPTION),
- * then this block will be used to handle it.
- *
- * One or more #CATCH blocks MAY follow a #TRY block. If <tt>type</tt> doesn't
- * match the thrown exception, then this block will be ignored, and the
- * exception MAY be caught by the following #CATCH or #CATCH_ALL blocks.
+ * Introduces a block of code that holds a read-write lock for reading.
  *
- * @attention
- * These blocks MUST NOT be exited through any of: <tt>goto</tt>,
- * <tt>break</tt>, <tt>continue</tt>, or <tt>return</tt>.
+ * This macro works just like #LOCKED, but it holds a
+ * <tt>pthread_rwlock_t</tt> shared with other readers.
  *
- * @param exception_type The type of exception to catch.
+ * @pre
+ * This macro is only available if #EXCEPTIONS4C_LOCKS is greater than zero.
  *
- * Example: @snippet pet-store.c catch
+ * @param rwlock A pointer to the <tt>pthread_rwlock_t</tt> to hold.
  *
- * @see TRY
- * @see CATCH_ALL
+ * @see LOCKED
+ * @see WRITE_LOCKED
  */
-#define CATCH(exception_type)                                               \
+#define READ_LOCKED(rwlock)                                                 \
                                                                             \
-    else if (EXCEPTION_IS_UNCAUGHT                                          \
-      && EXCEPTION_BLOCK.stage == 2                                         \
-      && (exception_type) == EXCEPTION.type                                 \
-      && (EXCEPTION_BLOCK.uncaught = 0, 1))
+  for (e4c_lock_rwlock((rwlock), EXCEPTION_LOCK_READ,                       \
+    EXCEPTION_LOCK_SITE); e4c_locked(); )
 
 /**
- * Introduces a block of code that handles any exception thrown by a preceding
- * #TRY block, regardless of its type.
- *
- * The #CATCH_ALL block works like a general #CATCH block that does not require
- * specifying the type of exception to handle. It MAY be used as a fallback for
- * catching all exceptions, including those not explicitly declared in other
- * #CATCH blocks.
- *
- * Only one #CATCH_ALL block is allowed per #TRY block, and it MUST appear after
- * all type-specific #CATCH blocks if any are present.
+ * Introduces a block of code that holds a read-write lock for writing.
  *
- * @remark
- * Using a #CATCH_ALL block is useful for logging, debugging, or handling
- * unexpected exceptions that don't fit into specific categories. However,
- * specific #CATCH blocks SHOULD be used whenever possible to maintain clarity
- * and precise control over exception handling.
+ * This macro works just like #LOCKED, but it holds a
+ * <tt>pthread_rwlock_t</tt> exclusively.
  *
- * @attention
- * These blocks MUST NOT be exited through any of: <tt>goto</tt>,
- * <tt>break</tt>, <tt>continue</tt>, or <tt>return</tt>.
+ * @pre
+ * This macro is only available if #EXCEPTIONS4C_LOCKS is greater than zero.
  *
- * Example: @snippet pet-store.c catch_all
+ * @param rwlock A pointer to the <tt>pthread_rwlock_t</tt> to hold.
  *
- * @see TRY
- * @see CATCH
+ * @see LOCKED
+ * @see READ_LOCKED
  */
-#define CATCH_ALL                                                           \
+#define WRITE_LOCKED(rwlock)                                                \
                                                                             \
-    else if (EXCEPTION_IS_UNCAUGHT                                          \
-      && EXCEPTION_BLOCK.stage == 2                                         \
-      && (EXCEPTION_BLOCK.uncaught = 0, 1))
+  for (e4c_lock_rwlock((rwlock), EXCEPTION_LOCK_WRITE,                      \
+    EXCEPTION_LOCK_SITE); e4c_locked(); )
+
+#if EXCEPTIONS4C_LOCK_STATS > 0
 
 /**
- * Introduces a block of code that is executed after a #TRY block, regardless of
- * whether an exception was thrown or not.
- *
- * Use this macro to run a block, no matter whether an exception happens or not.
- *
- * A #FINALLY block MUST be preceded by a single #TRY block, after all the
- * accompanying #CATCH and #CATCH_ALL blocks (if any). Only one #FINALLY block
- * is allowed per block.
- *
- * @attention
- * These blocks MUST NOT be exited through any of: <tt>goto</tt>,
- * <tt>break</tt>, <tt>continue</tt>, or <tt>return</tt>.
+ * Retrieves the contention measured at the #LOCKED blocks executed by the
+ * current thread.
  *
- * @remark
- * This macro SHOULD be used to release resources, close files, or perform
- * cleanup tasks.
+ * The result is a vector of #EXCEPTIONS4C_LOCK_STATS elements, in no
+ * particular order. Elements whose <tt>file</tt> is <tt>NULL</tt> are not used.
  *
- * Example: @snippet pet-store.c finally
+ * @pre
+ * This macro is only available if #EXCEPTIONS4C_LOCK_STATS is greater than
+ * zero.
  *
- * @see TRY
+ * @see EXCEPTION_PRINT_LOCK_STATS
  */
-#define FINALLY                                                             \
+#define LOCK_STATS                                                          \
                                                                             \
-    else if (EXCEPTION_BLOCK_RANGE_CHECK && EXCEPTION_BLOCK.stage == 3)
+  exceptions4c.locks.site
 
 /**
- * Throws an exception, interrupting the normal flow of execution.
- *
- * #THROW is used within a #TRY block, a #CATCH block, or any other function to
- * signal that an error has occurred. The thrown exception will be of the
- * specified <tt>type</tt>, and it MAY be handled by a preceding #CATCH block.
- *
- * If a thrown exception is not handled by any of the #CATCH blocks in the
- * current function, it propagates up the call stack to the function that called
- * the current function. This continues until the exception is either handled by
- * a #CATCH block higher in the stack, or it reaches the top level of the
- * program. If no #CATCH block handles the exception, the program terminates and
- * an error message is printed to the console.
- *
- * @remark
- * The error message will be copied as it is into the thrown #EXCEPTION. To use
- * a formatted error message, use #THROWF instead. If no message is specified,
- * then the default message for the exception type will be used.
- *
- * @important
- * Control never returns to the #THROW point.
+ * @internal
+ * @brief Returns the upper bound of a percentile of a histogram, in
+ * nanoseconds.
+ */
+static inline unsigned long long e4c_lock_percentile(
+    const unsigned long *histogram, int permille) {
+    unsigned long total = 0;
+    unsigned long count = 0;
+    int bucket;
+    for (bucket = 0; bucket < EXCEPTION_LOCK_BUCKETS; bucket++) {
+        total += histogram[bucket];
+    }
+    for (bucket = 0; bucket < EXCEPTION_LOCK_BUCKETS - 1; bucket++) {
+        count += histogram[bucket];
+        if (count * 1000 >= total * (unsigned long) permille) {
+            break;
+        }
+    }
+    return 2ULL << bucket;
+}
+
+/**
+ * @internal
+ * @brief Prints the contention measured at the #LOCKED blocks.
+ */
+static inline void e4c_print_lock_stats(void) {
+    int index;
+    (void) fprintf(stderr, "\n[exceptions4c-lite]: Lock statistics:\n");
+    for (index = 0; index < EXCEPTIONS4C_LOCK_STATS; index++) {
+        const struct e4c_lock_site *site = &exceptions4c.locks.site[index];
+        if (site->file == NULL) {
+            continue;
+        }
+        (void) fprintf(stderr, "    %s:%d acquired %lu, unwound %lu\n"
+            "        wait p50 < %llu ns, p99 < %llu ns;"
+            " hold p50 < %llu ns, p99 < %llu ns\n",
+            site->file, site->line, site->acquired, site->unwound,
+            e4c_lock_percentile(site->wait, 500),
+            e4c_lock_percentile(site->wait, 990),
+            e4c_lock_percentile(site->hold, 500),
+            e4c_lock_percentile(site->hold, 990));
+    }
+}
+
+/**
+ * Prints the contention measured at the #LOCKED blocks executed by the
+ * current thread to standard error output.
  *
- * Example: @snippet pet-store.c throw
+ * For each block, the number of times its lock was acquired and released by
+ * an exception is printed, along with the approximate median and 99th
+ * percentile of the time spent waiting for the lock and holding it.
  *
- * @param exception_type The type of the exception to throw.
- * @param error_message The error message.
+ * @pre
+ * This macro is only available if #EXCEPTIONS4C_LOCK_STATS is greater than
+ * zero.
  *
- * @see THROWF
- * @see CATCH
- * @see CATCH_ALL
+ * @see LOCK_STATS
  */
-#define THROW(exception_type, error_message)                                \
+#define EXCEPTION_PRINT_LOCK_STATS                                          \
                                                                             \
-  (EXCEPTION.type = (exception_type), EXCEPTION.name = (error_message),     \
-    (void) sprintf(EXCEPTION.message, "%.*s",                               \
-      (int) (EXCEPTIONS4C_MAX_LENGTH),                                      \
-      EXCEPTION.name ? EXCEPTION.name : EXCEPTION.type),                    \
-      EXCEPTION.name = #exception_type, EXCEPTION_RETHROW)
+  e4c_print_lock_stats()
 
-#ifndef THROWF
+#endif
+
+#endif
+
+#if EXCEPTIONS4C_LIVE_STATS > 0
 
 /**
- * Throws an exception with a formatted error message.
+ * @internal
+ * @brief Returns the size of the header of a segment of live statistics.
+ */
+#define EXCEPTION_LIVE_HEADER                                               \
+                                                                            \
+  ((sizeof(struct e4c_live_segment) + 63) & ~(size_t) 63)
+
+/**
+ * @internal
+ * @brief Returns the size of the live statistics of one thread.
+ */
+static inline size_t e4c_live_thread_size(unsigned sites) {
+    return (sizeof(struct e4c_live_thread)
+        + sites * sizeof(struct e4c_live_site) + 63) & ~(size_t) 63;
+}
+
+/**
+ * @internal
+ * @brief Returns the live statistics of a thread.
+ */
+static inline struct e4c_live_thread *e4c_live_thread_at(
+    const struct e4c_live_segment *segment, unsigned index) {
+    return (struct e4c_live_thread *) ((char *) segment
+        + EXCEPTION_LIVE_HEADER + index * e4c_live_thread_size(segment->sites));
+}
+
+/**
+ * @internal
+ * @brief Creates the segment of live statistics of the current process.
+ */
+static inline struct e4c_live_segment *e4c_live_open(void) {
+    struct e4c_live_segment *segment;
+    size_t size = EXCEPTION_LIVE_HEADER
+        + EXCEPTIONS4C_LIVE_THREADS * e4c_live_thread_size(
+            EXCEPTIONS4C_LIVE_STATS);
+    char name[32];
+    void *memory;
+    int descriptor;
+    (void) snprintf(name, sizeof(name), "/exceptions4c-%ld", (long) getpid());
+    descriptor = shm_open(name, O_CREAT | O_TRUNC | O_RDWR, 0600);
+    if (descriptor < 0) {
+        return NULL;
+    }
+    memory = ftruncate(descriptor, (off_t) size) == 0
+        ? mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0)
+        : MAP_FAILED;
+    (void) close(descriptor);
+    if (memory == MAP_FAILED) {
+        (void) shm_unlink(name);
+        return NULL;
+    }
+    segment = memory;
+    segment->version = EXCEPTION_LIVE_VERSION;
+    segment->threads = EXCEPTIONS4C_LIVE_THREADS;
+    segment->sites = EXCEPTIONS4C_LIVE_STATS;
+    segment->pid = (long) getpid();
+    segment->size = size;
+    atomic_store_explicit(&segment->magic, EXCEPTION_LIVE_MAGIC,
+        memory_order_release);
+    return segment;
+}
+
+/**
+ * Creates the segment of shared memory where the current process publishes
+ * its live statistics.
  *
- * This macro works just like #THROW, but it allows you to format the error
- * message, just as you would with <tt>printf</tt>.
+ * The segment is named <tt>/exceptions4c-PID</tt>, so that other processes
+ * MAY find it via #LIVE_STATS_MAP. No thread publishes its statistics until
+ * it is attached via #LIVE_STATS_ATTACH.
  *
- * @important
- * Control never returns to the #THROW point.
+ * Example:
+ * ```c
+ * struct e4c_live_segment *live = LIVE_STATS_OPEN();
+ * LIVE_STATS_ATTACH(live);
+ * ```
  *
- * Example: @snippet pet-store.c throw
+ * @pre
+ * This macro is only available if #EXCEPTIONS4C_LIVE_STATS is greater than
+ * zero.
  *
- * @param exception_type The type of the exception to throw.
- * @param format The error message.
- * @param ... A list of arguments that will be formatted according to
- *   <tt>format</tt>.
+ * @attention
+ * A forked child process inherits the attachment of the thread that forked
+ * it, so it MUST create and attach to a segment of its own before throwing
+ * any exception.
  *
- * @see THROW
- * @see CATCH
- * @see CATCH_ALL
+ * @return The segment; or <tt>NULL</tt> if it could not be created.
+ *
+ * @see LIVE_STATS_ATTACH
+ * @see LIVE_STATS_CLOSE
  */
-#define THROWF(exception_type, format, ...)                                 \
+#define LIVE_STATS_OPEN()                                                   \
                                                                             \
-  (EXCEPTION.type = (exception_type), EXCEPTION.name = #exception_type,     \
-    (void) snprintf(EXCEPTION.message, (EXCEPTIONS4C_MAX_LENGTH),           \
-      (format), __VA_ARGS__), EXCEPTION_RETHROW)
+  e4c_live_open()
 
-#endif
+/**
+ * @internal
+ * @brief Attaches the current thread to a segment of live statistics.
+ */
+static inline int e4c_live_attach(struct e4c_live_segment *segment) {
+    unsigned index;
+    if (segment == NULL) {
+        return 0;
+    }
+    index = atomic_fetch_add_explicit(&segment->attached, 1,
+        memory_order_relaxed);
+    if (index >= segment->threads) {
+        return 0;
+    }
+    memset(&exceptions4c.live, 0, sizeof(exceptions4c.live));
+    exceptions4c.live.thread = e4c_live_thread_at(segment, index);
+    e4c_live_depth();
+    return 1;
+}
 
 /**
- * Retrieves the last exception that was thrown.
+ * Makes the current thread publish its live statistics into a segment of
+ * shared memory.
  *
- * @remark
- * This macro SHOULD be used in the body of a #CATCH or #CATCH_ALL block to
- * inspect the exception being handled. It MAY also be used in the body of a
- * #FINALLY block to determine if an exception was thrown in the corresponding
- * #TRY block, or during the execution of a #CATCH or #CATCH_ALL block.
+ * Each thread SHOULD attach once, as soon as it starts. Threads are given a
+ * slot of the segment for the lifetime of the process.
  *
- * Example: @snippet pet-store.c catch_all_get_exception
+ * @pre
+ * This macro is only available if #EXCEPTIONS4C_LIVE_STATS is greater than
+ * zero.
  *
- * @return The last exception that was thrown.
+ * @param segment The segment created via #LIVE_STATS_OPEN.
+ * @return A nonzero value if the thread was attached; or zero if the segment
+ *   is <tt>NULL</tt> or more than #EXCEPTIONS4C_LIVE_THREADS threads are
+ *   attached already.
  *
- * @see e4c_exception
- * @see THROW
- * @see CATCH
- * @see FINALLY
- * @see EXCEPTION_IS_UNCAUGHT
+ * @see LIVE_STATS_OPEN
  */
-#define EXCEPTION                                                           \
+#define LIVE_STATS_ATTACH(segment)                                          \
                                                                             \
-  exceptions4c.thrown
+  e4c_live_attach(segment)
 
 /**
- * Determines whether the thrown exception was not caught.
+ * @internal
+ * @brief Removes the segment of live statistics of the current process.
+ */
+static inline void e4c_live_close(struct e4c_live_segment *segment) {
+    char name[32];
+    if (segment == NULL) {
+        return;
+    }
+    (void) snprintf(name, sizeof(name), "/exceptions4c-%ld", segment->pid);
+    exceptions4c.live.thread = NULL;
+    (void) munmap(segment, segment->size);
+    (void) shm_unlink(name);
+}
+
+/**
+ * Removes the segment of shared memory where the current process publishes
+ * its live statistics.
  *
- * An exception is considered "uncaught" if no matching #CATCH or #CATCH_ALL
- * block has been executed for it. In other words, this macro evaluates to a
- * truthy value if the exception has bypassed all specific exception-handling
- * logic and is propagating further. And it evaluates to a falsy value if no
- * exception was thrown in the #TRY block, or if an exception was successfully
- * caught.
+ * Otherwise, the segment outlives the process, so that its final statistics
+ * MAY still be read.
  *
- * @remark
- * This macro SHOULD be used exclusively in the body of a #FINALLY block to
- * check whether an exception thrown during the #TRY block has propagated past
- * all #CATCH and #CATCH_ALL blocks without being handled.
+ * @pre
+ * This macro is only available if #EXCEPTIONS4C_LIVE_STATS is greater than
+ * zero.
  *
- * Example: @snippet pet-store.c is_uncaught
+ * @attention
+ * Other threads attached to the segment MUST have finished already.
  *
- * @return A truthy value if the current exception (if any) has not yet been
- *   handled by any #CATCH or #CATCH_ALL block; a falsy value otherwise.
+ * @param segment The segment created via #LIVE_STATS_OPEN.
  *
- * @see FINALLY
- * @see EXCEPTION
+ * @see LIVE_STATS_OPEN
  */
-#define EXCEPTION_IS_UNCAUGHT                                               \
+#define LIVE_STATS_CLOSE(segment)                                           \
                                                                             \
-  (EXCEPTION_BLOCK_RANGE_CHECK && EXCEPTION_BLOCK.uncaught)
+  e4c_live_close(segment)
 
-#ifndef NDEBUG
+/**
+ * @internal
+ * @brief Maps the segment of live statistics of a process for reading.
+ */
+static inline const struct e4c_live_segment *e4c_live_map(long pid) {
+    const struct e4c_live_segment *segment;
+    struct stat status;
+    char name[32];
+    void *memory;
+    int descriptor;
+    (void) snprintf(name, sizeof(name), "/exceptions4c-%ld", pid);
+    descriptor = shm_open(name, O_RDONLY, 0);
+    if (descriptor < 0) {
+        return NULL;
+    }
+    memory = fstat(descriptor, &status) == 0
+        && (size_t) status.st_size >= EXCEPTION_LIVE_HEADER
+        ? mmap(NULL, (size_t) status.st_size, PROT_READ, MAP_SHARED,
+            descriptor, 0)
+        : MAP_FAILED;
+    (void) close(descriptor);
+    if (memory == MAP_FAILED) {
+        return NULL;
+    }
+    segment = memory;
+    if (atomic_load_explicit(&segment->magic, memory_order_acquire)
+        != EXCEPTION_LIVE_MAGIC || segment->version != EXCEPTION_LIVE_VERSION
+        || segment->size != (size_t) status.st_size
+        || segment->size != EXCEPTION_LIVE_HEADER
+            + segment->threads * e4c_live_thread_size(segment->sites)) {
+        (void) munmap(memory, (size_t) status.st_size);
+        return NULL;
+    }
+    return segment;
+}
 
 /**
- * Prints the current exception to standard error output and flushes it.
+ * Maps the segment of shared memory where a process publishes its live
+ * statistics, for reading.
  *
- * @see EXCEPTION
+ * @pre
+ * This macro is only available if #EXCEPTIONS4C_LIVE_STATS is greater than
+ * zero.
+ *
+ * @param pid The process that publishes the statistics.
+ * @return The segment; or <tt>NULL</tt> if it doesn't exist, it is not ready
+ *   yet, or it has an incompatible layout.
+ *
+ * @see LIVE_STATS_SNAPSHOT
+ * @see LIVE_STATS_UNMAP
  */
-#define EXCEPTION_PRINT                                                     \
+#define LIVE_STATS_MAP(pid)                                                 \
                                                                             \
-  (fprintf(stderr, "\n%s: %s\n    at %s:%d\n",                              \
-    EXCEPTION.name, EXCEPTION.message, EXCEPTION.file, EXCEPTION.line))
-
-#else
+  e4c_live_map(pid)
 
 /**
- * Prints the current exception to standard error output and flushes it.
+ * Unmaps a segment of live statistics mapped via #LIVE_STATS_MAP.
  *
- * @see EXCEPTION
+ * @pre
+ * This macro is only available if #EXCEPTIONS4C_LIVE_STATS is greater than
+ * zero.
+ *
+ * @param segment The segment to unmap.
  */
-#define EXCEPTION_PRINT                                                     \
+#define LIVE_STATS_UNMAP(segment)                                           \
                                                                             \
-  (fprintf(stderr, "\n%s: %s\n", EXCEPTION.name, EXCEPTION.message))
-
-#endif
-
-#ifndef NDEBUG
+  ((void) munmap((void *) (segment), (segment)->size))
 
 /**
- * Throws the current exception again.
+ * Returns the number of bytes needed to copy the live statistics of one
+ * thread of a segment.
  *
- * @remark
- * This macro SHOULD be used in the body of #CATCH or #CATCH_ALL blocks to throw
- * the exception that is currently being handled.
+ * @pre
+ * This macro is only available if #EXCEPTIONS4C_LIVE_STATS is greater than
+ * zero.
  *
- * @see CATCH
- * @see CATCH_ALL
+ * @param segment The segment mapped via #LIVE_STATS_MAP.
+ * @return The size of the statistics of one thread, in bytes.
+ *
+ * @see LIVE_STATS_SNAPSHOT
  */
-#define EXCEPTION_RETHROW                                                   \
+#define LIVE_STATS_THREAD_SIZE(segment)                                     \
                                                                             \
-  (EXCEPTION.file = __FILE__, EXCEPTION.line = __LINE__,                    \
-    (exceptions4c.blocks <= 0 && ((void) (EXCEPTIONS4C_TERMINATE), 0)),     \
-    EXCEPTION_PROPAGATE)
+  e4c_live_thread_size((segment)->sites)
 
-#else
+/**
+ * @internal
+ * @brief Copies the live statistics of a thread consistently.
+ */
+static inline int e4c_live_snapshot(const struct e4c_live_segment *segment,
+    unsigned index, struct e4c_live_thread *thread) {
+    const struct e4c_live_thread *source = e4c_live_thread_at(segment, index);
+    int attempt;
+    if (index >= segment->threads || index >= atomic_load_explicit(
+        (atomic_uint *) &segment->attached, memory_order_relaxed)) {
+        return 0;
+    }
+    for (attempt = 0; attempt < 1000; attempt++) {
+        unsigned sequence = atomic_load_explicit(
+            (atomic_uint *) &source->sequence, memory_order_acquire);
+        if (sequence % 2 != 0) {
+            continue;
+        }
+        memcpy(thread, source, e4c_live_thread_size(segment->sites));
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit((atomic_uint *) &source->sequence,
+            memory_order_relaxed) == sequence) {
+            return 1;
+        }
+    }
+    return 0;
+}
 
 /**
- * Throws the current exception again.
+ * Copies the live statistics of a thread, without blocking it.
  *
- * @remark
- * This macro SHOULD be used in the body of #CATCH or #CATCH_ALL blocks to throw
- * the exception that is currently being handled.
+ * The copy is consistent: all the counters of the thread are read at the same
+ * point in time. If the thread keeps publishing exceptions during the copy,
+ * the copy is attempted again.
  *
- * @see CATCH
- * @see CATCH_ALL
+ * Example:
+ * ```c
+ * struct e4c_live_thread *thread = malloc(LIVE_STATS_THREAD_SIZE(live));
+ * if (LIVE_STATS_SNAPSHOT(live, 0, thread)) {
+ *   printf("Thrown: %lu\n", thread->thrown);
+ * }
+ * ```
+ *
+ * @pre
+ * This macro is only available if #EXCEPTIONS4C_LIVE_STATS is greater than
+ * zero.
+ *
+ * @param segment The segment mapped via #LIVE_STATS_MAP.
+ * @param index The slot of the thread.
+ * @param thread The copy, of at least #LIVE_STATS_THREAD_SIZE bytes.
+ * @return A nonzero value if the thread was copied; or zero if no thread is
+ *   attached to that slot, or the copy could not be made consistent.
+ *
+ * @see LIVE_STATS_MAP
  */
-#define EXCEPTION_RETHROW                                                   \
+#define LIVE_STATS_SNAPSHOT(segment, index, thread)                         \
                                                                             \
-  ((exceptions4c.blocks <= 0 && ((void) (EXCEPTIONS4C_TERMINATE), 0)),      \
-    EXCEPTION_PROPAGATE)
+  e4c_live_snapshot((segment), (index), (thread))
 
 #endif
 
@@ -0,0 +1,43 @@
+/*
+ * Copyright 2025 Guillermo Calvo
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define EXCEPTIONS4C_ARENA_SIZE 1024
+#include <exceptions4c-lite.h>
+
+struct e4c_context exceptions4c = {0};
+const e4c_exception_type OOPS = "Oops";
+
+/**
+ * Tests macro ARENA_ALLOC.
+ */
+int main(void) {
+    volatile int allocated = 0, exhausted = 0, caught = 0; /* NOSONAR */
+
+    TRY {
+        char *buffer = ARENA_ALLOC(100);
+        allocated = buffer != NULL && ((size_t) buffer) % sizeof(union e4c_arena_unit) == 0;
+        exhausted = ARENA_ALLOC(EXCEPTIONS4C_ARENA_SIZE) == NULL;
+        TRY {
+            allocated = allocated && ARENA_ALLOC(1) != NULL;
+            THROW(OOPS, "Release everything");
+        }
+    } CATCH (OOPS) {
+        caught = 1;
+        printf("Caught: %s: %s\n", EXCEPTION.name, EXCEPTION.message);
+    }
+
+    return !allocated || !exhausted || !caught || exceptions4c.arena.used != 0;
+}
@@ -0,0 +1,182 @@
+/*
+ * Copyright 2025 Guillermo Calvo
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string.h>
+#include <exceptions4c-lite-arithmetic.h>
+
+struct e4c_context exceptions4c = {0};
+const e4c_exception_type ARITHMETIC_OVERFLOW = "Arithmetic overflow";
+
+#define LENGTH 1000
+
+static int32_t a32[LENGTH], b32[LENGTH], result32[LENGTH];
+static int64_t a64[LENGTH], b64[LENGTH], result64[LENGTH];
+static long long a_llong[LENGTH], b_llong[LENGTH], result_llong[LENGTH];
+static float a_float[LENGTH], b_float[LENGTH], result_float[LENGTH];
+
+/* Returns nonzero if the last exception has the expected message */
+static int thrown(const char *message) {
+    printf("Caught: %s\n", EXCEPTION.message);
+    return EXCEPTION.type == ARITHMETIC_OVERFLOW
+        && strcmp(EXCEPTION.message, message) == 0;
+}
+
+/**
+ * Tests macros CHECKED_ADD, CHECKED_SUB, CHECKED_MUL and CHECKED_DIV.
+ */
+static int scalars(void) {
+    volatile int ok = 1;
+    int32_t small = INT32_MAX;
+    int64_t large = INT64_MIN;
+
+    ok = ok && CHECKED_ADD(small, -1) == INT32_MAX - 1;
+    ok = ok && CHECKED_SUB(large, -1) == INT64_MIN + 1;
+    ok = ok && CHECKED_MUL((int32_t) -46341, 46340) == -2147441940;
+    ok = ok && CHECKED_DIV(large, 2) == INT64_MIN / 2;
+
+    TRY {
+        (void) CHECKED_ADD(small, 1);
+        ok = 0;
+    } CATCH (ARITHMETIC_OVERFLOW) {
+        ok = ok && thrown("Integer overflow: 2147483647 + 1");
+    }
+    TRY {
+        (void) CHECKED_SUB(large, 1);
+        ok = 0;
+    } CATCH (ARITHMETIC_OVERFLOW) {
+        ok = ok && thrown("Integer overflow: -9223372036854775808 - 1");
+    }
+    TRY {
+        (void) CHECKED_MUL((int32_t) 46341, 46341);
+        ok = 0;
+    } CATCH (ARITHMETIC_OVERFLOW) {
+        ok = ok && thrown("Integer overflow: 46341 * 46341");
+    }
+    TRY {
+        (void) CHECKED_DIV(small, 0);
+        ok = 0;
+    } CATCH (ARITHMETIC_OVERFLOW) {
+        ok = ok && thrown("Division by zero: 2147483647 / 0");
+    }
+    TRY {
+        (void) CHECKED_DIV(large, -1);
+        ok = 0;
+    } CATCH (ARITHMETIC_OVERFLOW) {
+        ok = ok && thrown("Integer overflow: -9223372036854775808 / -1");
+    }
+    return ok;
+}
+
+/**
+ * Tests macros CHECKED_ADD_ARRAY, CHECKED_MUL_ARRAY and CHECKED_SUM.
+ */
+static int arrays(void) {
+    volatile int ok = 1;
+
+    for (int index = 0; index < LENGTH; index++) {
+        a32[index] = b32[index] = index;
+        a64[index] = b64[index] = index;
+        a_llong[index] = b_llong[index] = index;
+        a_float[index] = b_float[index] = (float) index;
+    }
+
+    CHECKED_ADD_ARRAY(result32, a32, b32, LENGTH);
+    CHECKED_MUL_ARRAY(result64, a64, b64, LENGTH);
+    CHECKED_ADD_ARRAY(result_float, a_float, b_float, LENGTH);
+    CHECKED_MUL_ARRAY(result_llong, a_llong, b_llong, LENGTH);
+    ok = result32[999] == 1998 && result64[999] == 998001
+        && result_float[999] == 1998.0f && result_llong[999] == 998001
+        && CHECKED_SUM(result_llong, LENGTH) == 332833500
+        && CHECKED_SUM(a32, LENGTH) == 499500
+        && CHECKED_SUM(a64, LENGTH) == 499500
+        && CHECKED_SUM(a_float, LENGTH) == 499500.0f;
+
+    a32[700] = INT32_MAX;
+    a32[900] = INT32_MAX;
+    TRY {
+        CHECKED_ADD_ARRAY(result32, a32, b32, LENGTH);
+        ok = 0;
+    } CATCH (ARITHMETIC_OVERFLOW) {
+        ok = ok && thrown("Integer overflow at index 700: 2147483647 + 700");
+    }
+    TRY {
+        CHECKED_MUL_ARRAY(result32, a32, b32, LENGTH);
+        ok = 0;
+    } CATCH (ARITHMETIC_OVERFLOW) {
+        ok = ok && thrown("Integer overflow at index 700: 2147483647 * 700");
+    }
+    a64[500] = INT64_MAX;
+    TRY {
+        CHECKED_ADD_ARRAY(result64, a64, b64, LENGTH);
+        ok = 0;
+    } CATCH (ARITHMETIC_OVERFLOW) {
+        ok = ok && thrown(
+            "Integer overflow at index 500: 9223372036854775807 + 500");
+    }
+    TRY {
+        CHECKED_MUL_ARRAY(result64, a64, b64, LENGTH);
+        ok = 0;
+    } CATCH (ARITHMETIC_OVERFLOW) {
+        ok = ok && thrown(
+            "Integer overflow at index 500: 9223372036854775807 * 500");
+    }
+    a_llong[600] = LLONG_MAX;
+    TRY {
+        CHECKED_ADD_ARRAY(result_llong, a_llong, b_llong, LENGTH);
+        ok = 0;
+    } CATCH (ARITHMETIC_OVERFLOW) {
+        ok = ok && thrown(
+            "Integer overflow at index 600: 9223372036854775807 + 600");
+    }
+    TRY {
+        CHECKED_MUL_ARRAY(result_llong, a_llong, b_llong, LENGTH);
+        ok = 0;
+    } CATCH (ARITHMETIC_OVERFLOW) {
+        ok = ok && thrown(
+            "Integer overflow at index 600: 9223372036854775807 * 600");
+    }
+    b_float[300] = 3e38f;
+    a_float[300] = 3e38f;
+    TRY {
+        CHECKED_ADD_ARRAY(result_float, a_float, b_float, LENGTH);
+        ok = 0;
+    } CATCH (ARITHMETIC_OVERFLOW) {
+        ok = ok && thrown("Non-finite result at index 300: 3e+38 + 3e+38");
+    }
+    TRY {
+        (void) CHECKED_SUM(a32, LENGTH);
+        ok = 0;
+    } CATCH (ARITHMETIC_OVERFLOW) {
+        ok = ok && thrown("Integer overflow at index 700: 244650 + 2147483647");
+    }
+
+    /* partial sums MAY overflow as long as the total fits */
+    a64[501] = INT64_MIN;
+    ok = ok && CHECKED_SUM(a64, LENGTH) == 499500 - 500 - 501 - 1;
+    a64[501] = 0;
+    TRY {
+        (void) CHECKED_SUM(a64, LENGTH);
+        ok = 0;
+    } CATCH (ARITHMETIC_OVERFLOW) {
+        ok = ok && thrown(
+            "Integer overflow at index 500: 124750 + 9223372036854775807");
+    }
+    return ok;
+}
+
+int main(void) {
+    return !scalars() || !arrays();
+}
@@ -0,0 +1,66 @@
+/*
+ * Copyright 2025 Guillermo Calvo
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define EXCEPTIONS4C_ARENA_SIZE 1024
+#include <string.h>
+#include <exceptions4c-lite.h>
+
+struct e4c_context exceptions4c = {0};
+const e4c_exception_type BAD_RECORD = "Bad record";
+
+static const int records[] = {1, 2, -3, 4, 5, 6, -7, 8, -9, 10};
+
+static int transform(int record) {
+    if (record < 0) {
+        (void) ARENA_ALLOC(64);
+        THROWF(BAD_RECORD, "Negative record: %d", record);
+    }
+    return record * 2;
+}
+
+/**
+ * Tests macro BATCH_TRY.
+ */
+int main(void) {
+    struct e4c_batch_failure failures[2];
+    struct e4c_batch batch = {failures, 2};
+    volatile int total = 0;
+    volatile int caught = 0;
+    volatile int leaked = 0;
+    size_t index;
+
+    BATCH_TRY (index, sizeof(records) / sizeof(records[0]), &batch) {
+        leaked = leaked || exceptions4c.arena.used != 0;
+        total += transform(records[index]);
+    }
+
+    TRY {
+        BATCH_RETHROW(&batch);
+    } CATCH (BAD_RECORD) {
+        caught = 1;
+        printf("Caught: %s: %s\n", EXCEPTION.name, EXCEPTION.message);
+    }
+
+    return total != 72
+        || batch.failed != 3
+        || failures[0].index != 2
+        || failures[1].index != 6
+        || strcmp(failures[1].exception.message, "Negative record: -7") != 0
+        || strcmp(EXCEPTION.message, "3 elements failed; first at index 2: Negative record: -3") != 0
+        || !caught
+        || leaked
+        || exceptions4c.blocks != 0;
+}
@@ -0,0 +1,63 @@
+/*
+ * Copyright 2025 Guillermo Calvo
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define EXCEPTIONS4C_CANCELLATION 1
+#define EXCEPTIONS4C_THREAD_LOCAL _Thread_local
+#include <pthread.h>
+#include <exceptions4c-lite.h>
+
+EXCEPTIONS4C_THREAD_LOCAL struct e4c_context exceptions4c = {0};
+const e4c_exception_type CANCELLED = "Cancelled";
+
+static _Atomic(e4c_cancellation_token) worker_token;
+static volatile int cleaned = 0, cancelled = 0; /* NOSONAR */
+
+static void *worker(void *argument) {
+    (void) argument;
+    atomic_store(&worker_token, CANCELLATION_TOKEN);
+    TRY {
+        TRY {
+            for (;;) {
+                CHECKPOINT();
+            }
+        } FINALLY {
+            cleaned = 1;
+        }
+    } CATCH (CANCELLED) {
+        cancelled = 1;
+        printf("Caught: %s: %s\n", EXCEPTION.name, EXCEPTION.message);
+    }
+    return NULL;
+}
+
+/**
+ * Tests macro CHECKPOINT.
+ */
+int main(void) {
+    pthread_t thread;
+    e4c_cancellation_token token;
+
+    if (pthread_create(&thread, NULL, worker, NULL) != 0) {
+        return EXIT_FAILURE;
+    }
+    while ((token = atomic_load(&worker_token)) == NULL) {
+        /* wait for the worker to publish its token */
+    }
+    CANCEL(token);
+    (void) pthread_join(thread, NULL);
+
+    return !cleaned || !cancelled;
+}
@@ -0,0 +1,94 @@
+/*
+ * Copyright 2025 Guillermo Calvo
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define EXCEPTIONS4C_FAULT_INJECTION 1
+
+#include <exceptions4c-lite.h>
+
+struct e4c_context exceptions4c = {0};
+const e4c_exception_type IO_ERROR = "I/O error";
+const e4c_exception_type PARSE_ERROR = "Parse error";
+
+static int line;
+static int cleanups;
+
+static void read_block(void) {
+    /* The fault point must be on the same line as the assignment */
+    line = __LINE__; if (FAULT_INJECTED(IO_ERROR)) THROW(IO_ERROR, NULL);
+}
+
+static void parse_block(void) {
+    if (FAULT_INJECTED(PARSE_ERROR)) {
+        THROW(PARSE_ERROR, NULL);
+    }
+}
+
+static int run(int calls) {
+    volatile int failures = 0;
+    for (int call = 0; call < calls; call++) {
+        TRY {
+            read_block();
+            parse_block();
+        } CATCH_ALL {
+            failures++;
+        } FINALLY {
+            cleanups++;
+        }
+    }
+    return failures;
+}
+
+/**
+ * Tests macros INJECT_FAULTS and FAULT_INJECTED.
+ */
+int main(void) {
+    static char site[64];
+    int disabled, every, probability, by_site, other_site, by_variable;
+
+    disabled = run(100);
+
+    (void) INJECT_FAULTS("type=IO_ERROR,every=3");
+    every = run(9);
+
+    (void) INJECT_FAULTS("probability=0.25,seed=42");
+    probability = run(10000);
+
+    (void) snprintf(site, sizeof(site), "site=fault-injection.c:%d,every=1",
+        line);
+    (void) INJECT_FAULTS(site);
+    by_site = run(10);
+
+    (void) INJECT_FAULTS("site=fault-injection.c:1,every=1");
+    other_site = run(10);
+
+    (void) setenv("EXCEPTIONS4C_FAULTS", "type=PARSE_ERROR,every=2", 1);
+    (void) INJECT_FAULTS(NULL);
+    by_variable = run(10);
+
+    printf("disabled=%d every=%d probability=%d site=%d other=%d env=%d\n",
+        disabled, every, probability, by_site, other_site, by_variable);
+
+    return disabled != 0
+        || every != 3
+        || probability < 4000 || probability > 4800
+        || by_site != 10
+        || other_site != 0
+        || by_variable != 5
+        || INJECT_FAULTS("unknown=1")
+        || INJECT_FAULTS("probability=2")
+        || cleanups != 10139
+        || exceptions4c.blocks != 0;
+}
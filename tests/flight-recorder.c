@@ -0,0 +1,104 @@
+/*
+ * Copyright 2025 Guillermo Calvo
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define EXCEPTIONS4C_FLIGHT_RECORDER 4
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <exceptions4c-lite.h>
+
+struct e4c_context exceptions4c = {0};
+const e4c_exception_type OOPS = "Oops";
+const e4c_exception_type OTHER = "Other";
+
+/**
+ * Tests macro EXCEPTION_PRINT_HISTORY.
+ */
+static int history(void) {
+    const struct e4c_event *last;
+
+    TRY {
+        THROW(OTHER, NULL);
+    } CATCH (OTHER) {
+        printf("Caught: %s: %s\n", EXCEPTION.name, EXCEPTION.message);
+    }
+
+    TRY {
+        TRY {
+            THROW(OOPS, "A message longer than the recorder keeps");
+        } CATCH_ALL {
+            EXCEPTION_RETHROW;
+        }
+    } CATCH (OOPS) {
+        printf("Caught: %s: %s\n", EXCEPTION.name, EXCEPTION.message);
+    }
+
+    EXCEPTION_PRINT_HISTORY;
+
+    last = &exceptions4c.recorder.event[(exceptions4c.recorder.events - 1) % EXCEPTIONS4C_FLIGHT_RECORDER];
+
+    return exceptions4c.recorder.events != 6
+        || exceptions4c.recorder.event[0].type != OOPS
+        || exceptions4c.recorder.event[0].caught
+        || exceptions4c.recorder.event[0].depth != 2
+        || last->type != OOPS
+        || !last->caught
+        || last->depth != 1
+        || strlen(exceptions4c.recorder.event[0].message)
+        != EXCEPTION_EVENT_MESSAGE - 1
+        || strncmp(last->message, "A message longer", 16) != 0;
+}
+
+/**
+ * Tests macro EXCEPTION_PRINT_HISTORY_ON_ABORT.
+ */
+static int on_abort(void) {
+    char output[1024] = {0};
+    size_t length = 0;
+    ssize_t bytes;
+    int channel[2], status;
+    pid_t child;
+
+    if (pipe(channel) != 0 || (child = fork()) < 0) {
+        return 0;
+    }
+    if (child == 0) {
+        (void) dup2(channel[1], STDERR_FILENO);
+        if (!EXCEPTION_PRINT_HISTORY_ON_ABORT) {
+            _exit(EXIT_FAILURE);
+        }
+        TRY {
+            THROW(OTHER, "Before aborting");
+        } CATCH (OTHER) {
+            abort();
+        }
+        _exit(EXIT_SUCCESS);
+    }
+    (void) close(channel[1]);
+    while (length < sizeof(output) - 1 && (bytes = read(channel[0],
+        output + length, sizeof(output) - 1 - length)) > 0) {
+        length += (size_t) bytes;
+    }
+    (void) close(channel[0]);
+    printf("Child output: %s\n", output);
+    return waitpid(child, &status, 0) == child && WIFSIGNALED(status)
+        && WTERMSIG(status) == SIGABRT
+        && strstr(output, "caught OTHER: Before aborting") != NULL;
+}
+
+int main(void) {
+    return history() || !on_abort();
+}
@@ -0,0 +1,168 @@
+/*
+ * Copyright 2025 Guillermo Calvo
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define EXCEPTIONS4C_LIVE_STATS 8
+#define EXCEPTIONS4C_LIVE_THREADS 4
+#define EXCEPTIONS4C_THREAD_LOCAL _Thread_local
+#include <pthread.h>
+#include <sys/wait.h>
+#include <exceptions4c-lite.h>
+
+EXCEPTIONS4C_THREAD_LOCAL struct e4c_context exceptions4c = {0};
+const e4c_exception_type NOT_FOUND = "Not found";
+const e4c_exception_type TIMED_OUT = "Timed out";
+
+#define THROWS 1000
+
+static struct e4c_live_segment *live;
+static struct e4c_live_thread *thread;
+
+/* Returns the live statistics of a type, or NULL */
+static const struct e4c_live_site *find(const char *name) {
+    for (unsigned index = 0; index < EXCEPTIONS4C_LIVE_STATS; index++) {
+        if (strcmp(thread->site[index].name, name) == 0) {
+            return &thread->site[index];
+        }
+    }
+    return NULL;
+}
+
+static void *worker(void *argument) {
+    int *attached = argument;
+    *attached = LIVE_STATS_ATTACH(live);
+    for (int index = 0; index < THROWS; index++) {
+        TRY {
+            THROW(TIMED_OUT, NULL);
+        } CATCH (TIMED_OUT) {
+            /* ignore the timeout */
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Tests macros LIVE_STATS_OPEN, LIVE_STATS_ATTACH, LIVE_STATS_MAP and
+ * LIVE_STATS_SNAPSHOT.
+ */
+static int publish(const struct e4c_live_segment *segment) {
+    const struct e4c_live_site *site;
+    volatile int ok = 1;
+
+    for (int index = 0; index < 3; index++) {
+        TRY {
+            TRY {
+                THROW(NOT_FOUND, NULL);
+            } FINALLY {
+                ok = ok && exceptions4c.live.thread->depth == 2;
+            }
+        } CATCH (NOT_FOUND) {
+            ok = ok && exceptions4c.live.thread->depth == 1;
+        }
+    }
+    TRY {
+        THROW(TIMED_OUT, NULL);
+    } CATCH_ALL {
+        /* ignore the timeout */
+    }
+
+    ok = ok && LIVE_STATS_SNAPSHOT(segment, 0, thread);
+    ok = ok && thread->thrown == 4 && thread->caught == 4
+        && thread->terminated == 0 && thread->dropped == 0
+        && thread->depth == 0 && thread->max_depth == 2;
+    site = find("NOT_FOUND");
+    ok = ok && site != NULL && site->thrown == 3 && site->caught == 3;
+#ifndef NDEBUG
+    ok = ok && site != NULL && strstr(site->file, "live-stats.c") != NULL
+        && site->line > 0;
+#endif
+    site = find("TIMED_OUT");
+    ok = ok && site != NULL && site->thrown == 1 && site->caught == 1;
+    return ok;
+}
+
+/**
+ * Tests macros LIVE_STATS_ATTACH and LIVE_STATS_SNAPSHOT with many threads.
+ */
+static int threads(const struct e4c_live_segment *segment) {
+    pthread_t workers[EXCEPTIONS4C_LIVE_THREADS];
+    int attached[EXCEPTIONS4C_LIVE_THREADS];
+    int total = 0;
+    int ok = 1;
+
+    for (int index = 0; index < EXCEPTIONS4C_LIVE_THREADS; index++) {
+        (void) pthread_create(&workers[index], NULL, worker, &attached[index]);
+    }
+    for (int index = 0; index < EXCEPTIONS4C_LIVE_THREADS; index++) {
+        (void) pthread_join(workers[index], NULL);
+        total += attached[index];
+    }
+    ok = ok && total == EXCEPTIONS4C_LIVE_THREADS - 1;
+    for (unsigned index = 1; index < EXCEPTIONS4C_LIVE_THREADS; index++) {
+        ok = ok && LIVE_STATS_SNAPSHOT(segment, index, thread)
+            && thread->thrown == THROWS && thread->caught == THROWS
+            && find("TIMED_OUT") != NULL && find("NOT_FOUND") == NULL;
+    }
+    return ok && !LIVE_STATS_SNAPSHOT(segment, EXCEPTIONS4C_LIVE_THREADS,
+        thread);
+}
+
+/**
+ * Tests that the statistics of a terminated process can still be read.
+ */
+static int terminated(void) {
+    const struct e4c_live_segment *segment;
+    char name[32];
+    pid_t child = fork();
+    int status;
+    int ok;
+
+    if (child == 0) {
+        LIVE_STATS_ATTACH(LIVE_STATS_OPEN());
+        THROW(NOT_FOUND, "Terminate the child process");
+    }
+    ok = waitpid(child, &status, 0) == child && WIFEXITED(status)
+        && WEXITSTATUS(status) == EXIT_FAILURE;
+    segment = LIVE_STATS_MAP(child);
+    ok = ok && segment != NULL && segment->pid == child
+        && LIVE_STATS_SNAPSHOT(segment, 0, thread)
+        && thread->thrown == 1 && thread->terminated == 1;
+    if (segment != NULL) {
+        LIVE_STATS_UNMAP(segment);
+    }
+    (void) snprintf(name, sizeof(name), "/exceptions4c-%ld", (long) child);
+    (void) shm_unlink(name);
+    return ok;
+}
+
+int main(void) {
+    const struct e4c_live_segment *segment;
+    int ok;
+
+    live = LIVE_STATS_OPEN();
+    if (live == NULL || !LIVE_STATS_ATTACH(live)) {
+        return EXIT_FAILURE;
+    }
+    segment = LIVE_STATS_MAP(getpid());
+    if (segment == NULL) {
+        return EXIT_FAILURE;
+    }
+    thread = malloc(LIVE_STATS_THREAD_SIZE(segment));
+    ok = publish(segment) && threads(segment) && terminated();
+    LIVE_STATS_UNMAP(segment);
+    LIVE_STATS_CLOSE(live);
+    free(thread);
+    return !ok || LIVE_STATS_MAP(getpid()) != NULL;
+}
@@ -0,0 +1,158 @@
+/*
+ * Copyright 2025 Guillermo Calvo
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define EXCEPTIONS4C_LOCKS 4
+#define EXCEPTIONS4C_LOCK_STATS 8
+#define EXCEPTIONS4C_THREAD_LOCAL _Thread_local
+#include <pthread.h>
+#include <exceptions4c-lite.h>
+
+EXCEPTIONS4C_THREAD_LOCAL struct e4c_context exceptions4c = {0};
+const e4c_exception_type TRANSFER_FAILED = "Transfer failed";
+const e4c_exception_type OTHER = "Other";
+
+#define THREADS 4
+#define TRANSFERS 10000
+#define FAILURES (TRANSFERS / 10)
+
+static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_rwlock_t rwlock = PTHREAD_RWLOCK_INITIALIZER;
+static long balance = 0;
+
+/* Returns nonzero if the mutex is not held */
+static int mutex_free(void) {
+    return pthread_mutex_trylock(&mutex) == 0
+        && pthread_mutex_unlock(&mutex) == 0;
+}
+
+/* Returns nonzero if the read-write lock is not held */
+static int rwlock_free(void) {
+    return pthread_rwlock_trywrlock(&rwlock) == 0
+        && pthread_rwlock_unlock(&rwlock) == 0;
+}
+
+/* Returns nonzero if the read-write lock is not held for writing */
+static int rwlock_readable(void) {
+    return pthread_rwlock_tryrdlock(&rwlock) == 0
+        && pthread_rwlock_unlock(&rwlock) == 0;
+}
+
+/**
+ * Tests macros LOCKED, READ_LOCKED and WRITE_LOCKED.
+ */
+static int unwinding(void) {
+    volatile int ok = 1;
+
+    LOCKED (&mutex) {
+        ok = ok && !mutex_free();
+    }
+    ok = ok && mutex_free();
+
+    TRY {
+        LOCKED (&mutex) {
+            READ_LOCKED (&rwlock) {
+                ok = ok && rwlock_readable() && !rwlock_free();
+                THROW(TRANSFER_FAILED, "Release both locks");
+            }
+        }
+        ok = 0;
+    } CATCH (TRANSFER_FAILED) {
+        ok = ok && mutex_free() && rwlock_free();
+    }
+
+    LOCKED (&mutex) {
+        TRY {
+            WRITE_LOCKED (&rwlock) {
+                ok = ok && !rwlock_readable();
+                THROW(TRANSFER_FAILED, "Release the inner lock only");
+            }
+        } CATCH (TRANSFER_FAILED) {
+            ok = ok && !mutex_free() && rwlock_free();
+        }
+    }
+    ok = ok && mutex_free();
+
+    TRY_CATCHING(TRANSFER_FAILED) {
+        LOCKED (&mutex) {
+            TRY_CATCHING(OTHER) {
+                WRITE_LOCKED (&rwlock) {
+                    THROW(TRANSFER_FAILED, "Skip the inner block");
+                }
+            } CATCH (OTHER) {
+                ok = 0;
+            }
+        }
+    } CATCH (TRANSFER_FAILED) {
+        ok = ok && mutex_free() && rwlock_free();
+    }
+
+    return ok && exceptions4c.locks.held == 0 && exceptions4c.blocks == 0;
+}
+
+/**
+ * Tests macros LOCKED and LOCK_STATS with many threads.
+ */
+static void *transfer(void *argument) {
+    volatile int failed = 0;
+    int *ok = argument;
+    int sites = 0;
+    for (int index = 0; index < TRANSFERS; index++) {
+        TRY {
+            LOCKED (&mutex) {
+                balance++;
+                if (index % 10 == 0) {
+                    THROW(TRANSFER_FAILED, NULL);
+                }
+            }
+        } CATCH (TRANSFER_FAILED) {
+            failed++;
+        }
+    }
+    for (int index = 0; index < EXCEPTIONS4C_LOCK_STATS; index++) {
+        const struct e4c_lock_site *site = &LOCK_STATS[index];
+        unsigned long waited = 0, held = 0;
+        if (site->file == NULL) {
+            continue;
+        }
+        for (int bucket = 0; bucket < EXCEPTION_LOCK_BUCKETS; bucket++) {
+            waited += site->wait[bucket];
+            held += site->hold[bucket];
+        }
+        sites++;
+        *ok = site->acquired == TRANSFERS && site->unwound == FAILURES
+            && waited == TRANSFERS && held == TRANSFERS;
+    }
+    *ok = *ok && sites == 1 && failed == FAILURES
+        && exceptions4c.locks.held == 0;
+    return NULL;
+}
+
+int main(void) {
+    pthread_t threads[THREADS];
+    int ok[THREADS];
+    int all = unwinding();
+
+    for (int index = 0; index < THREADS; index++) {
+        ok[index] = 0;
+        (void) pthread_create(&threads[index], NULL, transfer, &ok[index]);
+    }
+    for (int index = 0; index < THREADS; index++) {
+        (void) pthread_join(threads[index], NULL);
+        all = all && ok[index];
+    }
+    EXCEPTION_PRINT_LOCK_STATS;
+    return !all || balance != THREADS * TRANSFERS;
+}
@@ -0,0 +1,51 @@
+/*
+ * Copyright 2025 Guillermo Calvo
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define EXCEPTIONS4C_OUT_OF_LINE 1
+#include <string.h>
+#include <exceptions4c-lite.h>
+
+struct e4c_context exceptions4c = {0};
+const e4c_exception_type OOPS = "Oops";
+
+/**
+ * Tests macro EXCEPTIONS4C_OUT_OF_LINE.
+ */
+int main(void) {
+    volatile int thrown = 0, formatted = 0, rethrown = 0, cleaned = 0; /* NOSONAR */
+
+    TRY {
+        THROW(OOPS, NULL);
+    } CATCH (OOPS) {
+        thrown = strcmp(EXCEPTION.name, "OOPS") == 0 && strcmp(EXCEPTION.message, "Oops") == 0;
+    }
+
+    TRY {
+        TRY {
+            THROWF(OOPS, "%s_%d", "FORMATTED", 1);
+        } CATCH (OOPS) {
+            formatted = strcmp(EXCEPTION.message, "FORMATTED_1") == 0;
+            EXCEPTION_RETHROW;
+        } FINALLY {
+            cleaned = 1;
+        }
+    } CATCH_ALL {
+        printf("Caught: %s: %s\n", EXCEPTION.name, EXCEPTION.message);
+        rethrown = EXCEPTION.type == OOPS;
+    }
+
+    return !thrown || !formatted || !rethrown || !cleaned;
+}
@@ -0,0 +1,90 @@
+/*
+ * Copyright 2025 Guillermo Calvo
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <pthread.h>
+#include <exceptions4c-lite-registry.h>
+
+struct e4c_context exceptions4c = {0};
+struct e4c_registry exceptions4c_registry = {0};
+
+#define THREADS 4
+#define NAMES 100
+
+static e4c_exception_type interned[THREADS][NAMES];
+
+static void *intern_names(void *argument) {
+    e4c_exception_type *types = argument;
+    char name[32];
+    for (int index = 0; index < NAMES; index++) {
+        (void) snprintf(name, sizeof(name), "Type %d", index);
+        types[index] = INTERN_TYPE(name);
+    }
+    return NULL;
+}
+
+/* Simulates a plugin that defines its own copy of a type */
+static void plugin_throw(void) {
+    char name[] = "Plugin error";
+    e4c_exception_type plugin_error = INTERN_TYPE(name);
+    THROW(plugin_error, NULL);
+}
+
+/**
+ * Tests macros INTERN_TYPE, RELEASE_TYPE, TYPE_ID and TYPE_REFERENCES.
+ */
+int main(void) {
+    pthread_t threads[THREADS];
+    e4c_exception_type plugin_error = INTERN_TYPE("Plugin error");
+    volatile int caught = 0;
+    int unique = 1;
+
+    TRY {
+        plugin_throw();
+    } CATCH (plugin_error) {
+        caught = 1;
+        printf("Caught: %s (ID %u)\n", EXCEPTION.message, TYPE_ID(plugin_error));
+    }
+
+    for (int thread = 0; thread < THREADS; thread++) {
+        (void) pthread_create(&threads[thread], NULL, intern_names,
+            interned[thread]);
+    }
+    for (int thread = 0; thread < THREADS; thread++) {
+        (void) pthread_join(threads[thread], NULL);
+    }
+    for (int index = 0; index < NAMES; index++) {
+        for (int thread = 1; thread < THREADS; thread++) {
+            unique &= interned[thread][index] == interned[0][index];
+        }
+        unique &= TYPE_ID(interned[0][index]) >= 2
+            && TYPE_ID(interned[0][index]) <= NAMES + 1
+            && TYPE_REFERENCES(interned[0][index]) == THREADS;
+    }
+
+    RELEASE_TYPE(plugin_error);
+    for (int thread = 0; thread <= THREADS; thread++) {
+        RELEASE_TYPE(interned[0][0]);
+    }
+
+    return !caught
+        || !unique
+        || TYPE_ID(plugin_error) != 1
+        || TYPE_REFERENCES(plugin_error) != 1
+        || TYPE_REFERENCES(interned[0][0]) != 0
+        || INTERN_TYPE("Plugin error") != plugin_error
+        || TYPE_ID("Plugin error") != 0
+        || exceptions4c_registry.types != NAMES + 1;
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright 2025 Guillermo Calvo
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define EXCEPTIONS4C_RETRY 1
+
+#include <exceptions4c-lite.h>
+
+struct e4c_context exceptions4c = {0};
+const e4c_exception_type TRANSIENT = "Transient error";
+const e4c_exception_type FATAL = "Fatal error";
+
+static int hooks;
+static unsigned long delays;
+
+static void on_attempt(int attempt, unsigned long delay,
+    const struct e4c_exception *exception) {
+    printf("Attempt %d failed (%s), waiting %lu ms\n", attempt,
+        exception->type, delay);
+    hooks++;
+    delays += delay;
+}
+
+static void flaky(volatile int *calls, int failures, e4c_exception_type type,
+    int blocks) {
+    if (exceptions4c.blocks != blocks) {
+        THROW(FATAL, "Attempts must reuse the same block");
+    }
+    if (++*calls <= failures) {
+        THROW(type, "Failed");
+    }
+}
+
+/**
+ * Tests macros RETRY and RETRY_POLICY.
+ */
+int main(void) {
+    static const struct e4c_retry_policy policy = {
+        BACKOFF_FIXED, 1, 0, on_attempt
+    };
+    volatile int recovered = 0, exhausted = 0, fatal = 0;
+    volatile int exhausted_attempts = 0, fatal_attempts = 0;
+
+    /* Succeeds after two transient failures */
+    RETRY (5, TRANSIENT) {
+        flaky(&recovered, 2, TRANSIENT, 1);
+    }
+
+    (void) RETRY_POLICY(&policy);
+
+    /* Gives up after three attempts */
+    TRY {
+        RETRY (3, TRANSIENT) {
+            flaky(&exhausted, 10, TRANSIENT, 2);
+        }
+    } CATCH (TRANSIENT) {
+        exhausted_attempts = EXCEPTION.attempts;
+    }
+
+    /* Doesn't retry other exception types */
+    TRY {
+        RETRY (3, TRANSIENT) {
+            flaky(&fatal, 10, FATAL, 2);
+        }
+    } CATCH (FATAL) {
+        fatal_attempts = EXCEPTION.attempts;
+    }
+
+    return recovered != 3
+        || exhausted != 3 || exhausted_attempts != 3
+        || fatal != 1 || fatal_attempts != 0
+        || hooks != 3 || delays != 2
+        || exceptions4c.blocks != 0;
+}
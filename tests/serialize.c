@@ -0,0 +1,297 @@
+/*
+ * Copyright 2025 Guillermo Calvo
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <exceptions4c-lite-serialize.h>
+
+struct e4c_context exceptions4c = {0};
+
+const e4c_exception_type JOB_FAILED = "Job failed";
+const e4c_exception_type WORKER_CRASHED = "Worker crashed";
+const e4c_exception_type CHILD_ONLY = "Known only by the child";
+
+static const e4c_exception_type known_types[] = {JOB_FAILED, NULL};
+
+#define WORKERS 3
+
+/* The payload sent by workers */
+struct job {
+    int id;
+    int line;
+};
+
+/* Runs a job in a worker process and sends its exception to the parent */
+static void worker(int channel, int id) {
+    volatile struct job job = {id, 0};
+    if (fork() != 0) {
+        return;
+    }
+    TRY {
+        if (id == WORKERS - 1) {
+            THROW(CHILD_ONLY, NULL);
+        }
+        job.line = __LINE__; THROWF(JOB_FAILED, "Job %d failed", id);
+    } CATCH_ALL {
+        struct job sent = {job.id, job.line};
+        _exit(SEND_EXCEPTION(channel, &sent, sizeof(sent)) ? EXIT_SUCCESS
+            : EXIT_FAILURE);
+    }
+    _exit(EXIT_FAILURE);
+}
+
+/* Decodes a record from a buffer that is gone when the exception is caught */
+static void rethrow(const void *record, size_t size) {
+    _Alignas(8) unsigned char buffer[EXCEPTIONS4C_RECORD_SIZE];
+    struct e4c_record_view view;
+    memcpy(buffer, record, size);
+    if (DECODE_EXCEPTION(&view, buffer, size)) {
+        THROW_RECORD(RESOLVE_TYPE(&view, known_types), &view);
+    }
+}
+
+/* Overwrites the stack where the buffer of rethrow used to be */
+static void scribble(void) {
+    volatile unsigned char garbage[2 * EXCEPTIONS4C_RECORD_SIZE];
+    for (size_t index = 0; index < sizeof(garbage); index++) {
+        garbage[index] = 'X';
+    }
+}
+
+/**
+ * Tests macros SEND_EXCEPTION, RECEIVE_EXCEPTION, DECODE_EXCEPTION,
+ * RESOLVE_TYPE and THROW_RECORD.
+ */
+static int pipes(void) {
+    volatile int ok = 1;
+    int received = 0;
+    int channel[2];
+    struct job job;
+    int status;
+    _Alignas(8) unsigned char buffer[EXCEPTIONS4C_RECORD_SIZE];
+    struct e4c_record_view record;
+    size_t size;
+
+    if (pipe(channel) != 0) {
+        return 0;
+    }
+    for (int id = 0; id < WORKERS; id++) {
+        worker(channel[1], id);
+    }
+    (void) close(channel[1]);
+    while ((size = RECEIVE_EXCEPTION(channel[0], buffer, sizeof(buffer)))) {
+        received++;
+        ok = ok && DECODE_EXCEPTION(&record, buffer, size);
+        ok = ok && record.payload_size == sizeof(job);
+        memcpy(&job, record.payload, sizeof(job));
+        TRY {
+            e4c_exception_type type = RESOLVE_TYPE(&record, known_types);
+            THROW_RECORD(type != NULL ? type : WORKER_CRASHED, &record);
+        } CATCH (JOB_FAILED) {
+            char message[32];
+            (void) snprintf(message, sizeof(message), "Job %d failed", job.id);
+            ok = ok && job.id < WORKERS - 1
+                && strcmp(EXCEPTION.name, "JOB_FAILED") == 0
+                && strcmp(EXCEPTION.message, message) == 0;
+#ifndef NDEBUG
+            ok = ok && strcmp(EXCEPTION.file, __FILE__) == 0
+                && EXCEPTION.line == job.line;
+#endif
+        } CATCH (WORKER_CRASHED) {
+            ok = ok && job.id == WORKERS - 1
+                && strcmp(record.type, CHILD_ONLY) == 0
+                && strcmp(EXCEPTION.name, "CHILD_ONLY") == 0
+                && strcmp(EXCEPTION.message, CHILD_ONLY) == 0;
+        }
+    }
+    (void) close(channel[0]);
+    while (wait(&status) > 0) {
+        ok = ok && WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS;
+    }
+    return ok && received == WORKERS;
+}
+
+/**
+ * Tests macros PUBLISH_EXCEPTION and DECODE_SLOT.
+ */
+static int shared_memory(void) {
+    volatile int ok = 1;
+    int published = 0;
+    int status;
+    struct e4c_record_view record;
+    struct e4c_record_slot *slot = mmap(NULL, sizeof(*slot),
+        PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+
+    if (slot == MAP_FAILED) {
+        return 0;
+    }
+    ok = ok && !DECODE_SLOT(&record, slot);
+    if (fork() == 0) {
+        TRY {
+            THROW(JOB_FAILED, "Out of disk space");
+        } CATCH_ALL {
+            _exit(PUBLISH_EXCEPTION(slot, NULL, 0)
+                && !PUBLISH_EXCEPTION(slot, NULL, 0)
+                ? EXIT_SUCCESS : EXIT_FAILURE);
+        }
+    }
+    ok = ok && wait(&status) > 0 && WIFEXITED(status)
+        && WEXITSTATUS(status) == EXIT_SUCCESS;
+    ok = ok && DECODE_SLOT(&record, slot);
+    TRY {
+        THROW_RECORD(RESOLVE_TYPE(&record, known_types), &record);
+    } CATCH (JOB_FAILED) {
+        atomic_store(&slot->size, 0);
+        memset(slot->record, 'X', sizeof(slot->record));
+        ok = ok && strcmp(EXCEPTION.name, "JOB_FAILED") == 0
+            && strcmp(EXCEPTION.message, "Out of disk space") == 0;
+    }
+    ok = ok && !DECODE_SLOT(&record, slot);
+    for (int index = 0; index < WORKERS; index++) {
+        if (fork() == 0) {
+            TRY {
+                THROW(JOB_FAILED, NULL);
+            } CATCH_ALL {
+                _exit(PUBLISH_EXCEPTION(slot, &index, sizeof(index))
+                    ? EXIT_SUCCESS : EXIT_FAILURE);
+            }
+        }
+    }
+    while (wait(&status) > 0) {
+        published += WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS;
+    }
+    ok = ok && published == 1 && DECODE_SLOT(&record, slot)
+        && record.payload_size == sizeof(int);
+    (void) munmap(slot, sizeof(*slot));
+    return ok;
+}
+
+/**
+ * Tests that exceptions thrown by macro THROW_RECORD outlive the record.
+ */
+static int out_of_scope(void) {
+    volatile int ok = 1;
+    _Alignas(8) unsigned char buffer[EXCEPTIONS4C_RECORD_SIZE];
+    volatile size_t size = 0;
+
+    TRY {
+        THROW(JOB_FAILED, "Lost connection");
+    } CATCH (JOB_FAILED) {
+        size = ENCODE_EXCEPTION(buffer, sizeof(buffer), NULL, 0);
+    }
+    TRY {
+        rethrow(buffer, size);
+        ok = 0;
+    } CATCH (JOB_FAILED) {
+        memset(buffer, 'X', sizeof(buffer));
+        scribble();
+        ok = ok && strcmp(EXCEPTION.name, "JOB_FAILED") == 0
+            && strcmp(EXCEPTION.message, "Lost connection") == 0;
+#ifndef NDEBUG
+        ok = ok && strcmp(EXCEPTION.file, __FILE__) == 0;
+#endif
+    }
+    return ok && size > 0;
+}
+
+/**
+ * Tests macros ENCODE_EXCEPTION and DECODE_EXCEPTION with invalid records.
+ */
+static int invalid_records(void) {
+    volatile int ok = 1;
+    _Alignas(8) unsigned char buffer[EXCEPTIONS4C_RECORD_SIZE];
+    struct e4c_record_view record;
+    volatile size_t size = 0;
+    double payload = 1.5;
+
+    TRY {
+        THROW(JOB_FAILED, "Corrupt record");
+    } CATCH (JOB_FAILED) {
+        ok = ok && ENCODE_EXCEPTION(buffer, 32, NULL, 0) == 0;
+        size = ENCODE_EXCEPTION(buffer, sizeof(buffer), &payload,
+            sizeof(payload));
+    }
+    ok = ok && size > 0 && DECODE_EXCEPTION(&record, buffer, size);
+    ok = ok && *(const double *) record.payload == payload;
+    ok = ok && !DECODE_EXCEPTION(&record, buffer, size - 1);
+    buffer[3]++;
+    ok = ok && !DECODE_EXCEPTION(&record, buffer, size);
+    buffer[3]--;
+    buffer[12]++;
+    ok = ok && !DECODE_EXCEPTION(&record, buffer, size);
+    buffer[12]--;
+    ok = ok && DECODE_EXCEPTION(&record, buffer, size);
+    return ok;
+}
+
+/**
+ * Tests macro RECEIVE_EXCEPTION with a foreign header that claims a huge size.
+ */
+static int foreign_header(void) {
+    _Alignas(8) unsigned char buffer[EXCEPTIONS4C_RECORD_SIZE];
+    unsigned char header[EXCEPTION_RECORD_HEADER];
+    int channel[2];
+    int ok;
+
+    if (pipe(channel) != 0) {
+        return 0;
+    }
+    (void) memset(header, 0xFF, sizeof(header));
+    (void) memcpy(header, "XYZ", 3);
+    ok = write(channel[1], header, sizeof(header)) == sizeof(header);
+    (void) close(channel[1]);
+    ok = ok && RECEIVE_EXCEPTION(channel[0], buffer, sizeof(buffer)) == 0
+        && errno == EBADMSG;
+    (void) close(channel[0]);
+    return ok;
+}
+
+/**
+ * Tests macro RECEIVE_EXCEPTION with records that don't fit in the buffer.
+ */
+static int oversized_records(void) {
+    _Alignas(8) unsigned char buffer[EXCEPTIONS4C_RECORD_SIZE];
+    struct e4c_record_view record;
+    char payload[100] = {0};
+    int channel[2];
+    int ok = 1;
+
+    if (pipe(channel) != 0) {
+        return 0;
+    }
+    TRY {
+        THROW(JOB_FAILED, "Too big");
+    } CATCH (JOB_FAILED) {
+        ok = ok && SEND_EXCEPTION(channel[1], payload, sizeof(payload));
+        ok = ok && SEND_EXCEPTION(channel[1], NULL, 0);
+    }
+    (void) close(channel[1]);
+    ok = ok && RECEIVE_EXCEPTION(channel[0], buffer, 64) == 0
+        && errno == EMSGSIZE;
+    ok = ok && DECODE_EXCEPTION(&record, buffer,
+        RECEIVE_EXCEPTION(channel[0], buffer, sizeof(buffer)))
+        && record.payload_size == 0;
+    ok = ok && RECEIVE_EXCEPTION(channel[0], buffer, sizeof(buffer)) == 0
+        && errno == 0;
+    (void) close(channel[0]);
+    return ok && foreign_header();
+}
+
+int main(void) {
+    return !pipes() || !shared_memory() || !out_of_scope()
+        || !invalid_records() || !oversized_records();
+}
@@ -0,0 +1,56 @@
+/*
+ * Copyright 2025 Guillermo Calvo
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <exceptions4c-lite.h>
+
+struct e4c_context exceptions4c = {0};
+const e4c_exception_type OOPS = "Oops";
+
+struct job {
+    int limit;
+    int total;
+};
+
+static void sum(void *argument) {
+    struct job *job = argument;
+    int total = 0;
+    for (int value = 1; value <= job->limit; value++) {
+        if (value > 100) {
+            THROW(OOPS, "Too many values");
+        }
+        total += value;
+    }
+    job->total = total;
+}
+
+/**
+ * Tests macro TRY_CALL.
+ */
+int main(void) {
+    struct job small = {10, 0}, large = {1000, 0};
+    int caught = 0;
+
+    TRY_CALL(sum, &small) CATCH (OOPS) {
+        caught = 1;
+    }
+
+    TRY_CALL(sum, &large) CATCH (OOPS) {
+        caught += 2;
+        printf("Caught: %s: %s\n", EXCEPTION.name, EXCEPTION.message);
+    }
+
+    return small.total != 55 || large.total != 0 || caught != 2;
+}
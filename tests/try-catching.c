@@ -0,0 +1,75 @@
+/*
+ * Copyright 2025 Guillermo Calvo
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <exceptions4c-lite.h>
+
+struct e4c_context exceptions4c = {0};
+const e4c_exception_type OOPS = "Oops";
+const e4c_exception_type OTHER = "Other";
+
+/**
+ * Tests macro TRY_CATCHING followed by cleanup.
+ */
+static int cleanup(void) {
+    volatile int finally = 0, catch_all = 0, caught = 0; /* NOSONAR */
+
+    TRY {
+        TRY_CATCHING(OTHER) {
+            TRY_CATCHING(OTHER) {
+                THROW(OOPS, "Run the cleanup of both blocks");
+            } CATCH (OTHER) {
+                caught = -1;
+            } FINALLY {
+                finally = exceptions4c.blocks == 3;
+            }
+        } CATCH_ALL {
+            catch_all = EXCEPTION.type == OOPS && exceptions4c.blocks == 2;
+        }
+    } CATCH (OOPS) {
+        caught = 1;
+    }
+
+    return finally && catch_all && !caught && exceptions4c.blocks == 0;
+}
+
+/**
+ * Tests macro TRY_CATCHING.
+ */
+int main(void) {
+    volatile int wrong = 0, cleaned = 0, caught = 0; /* NOSONAR */
+
+    TRY_CATCHING(OOPS) {
+        TRY {
+            TRY_CATCHING(OTHER) {
+                TRY_CATCHING(OTHER) {
+                    THROW(OOPS, "Skip the inner blocks");
+                } CATCH (OTHER) {
+                    wrong = 1;
+                }
+            } CATCH (OTHER) {
+                wrong = 1;
+            }
+        } FINALLY {
+            cleaned = exceptions4c.blocks == 2;
+        }
+    } CATCH (OOPS) {
+        caught = 1;
+        printf("Caught: %s: %s\n", EXCEPTION.name, EXCEPTION.message);
+    }
+
+    return wrong || !cleaned || !caught || exceptions4c.blocks != 0
+        || !cleanup();
+}
@@ -0,0 +1,117 @@
+/*
+ * Copyright 2025 Guillermo Calvo
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <signal.h>
+#include <time.h>
+
+static unsigned long long now(void);
+
+#define EXCEPTIONS4C_DEADLINES 1
+#define EXCEPTIONS4C_DEADLINE_SIGNAL SIGALRM
+#define EXCEPTIONS4C_CLOCK now()
+#include <exceptions4c-lite.h>
+
+struct e4c_context exceptions4c = {0};
+const e4c_exception_type TIMEOUT = "Timeout";
+
+static volatile sig_atomic_t trap = 0;
+static volatile unsigned long long skew = 0;
+
+/* Returns the current time, raising the signal first if a trap is set */
+static unsigned long long now(void) {
+    struct timespec time;
+    if (trap) {
+        trap = 0;
+        (void) raise(SIGALRM);
+    }
+    (void) clock_gettime(CLOCK_MONOTONIC, &time);
+    return (unsigned long long) time.tv_sec * 1000
+        + (unsigned long long) time.tv_nsec / 1000000 + skew;
+}
+
+/**
+ * Tests that the signal doesn't interrupt a block before it is armed.
+ *
+ * The setup of a TRY_WITHIN block reads the clock after the block is entered
+ * but before its jump buffer is set, so the trap raises the signal right then.
+ */
+static int entering(void) {
+    volatile int timed_out = 0; /* NOSONAR */
+    volatile int inner = 0; /* NOSONAR */
+
+    TRY_WITHIN(1000) {
+        skew += 2000;
+        trap = 1;
+        TRY_WITHIN(1000) {
+            inner = 1;
+            CHECKPOINT();
+            inner = 0;
+        }
+    } CATCH (TIMEOUT) {
+        timed_out = 1;
+    }
+    return timed_out && inner && trap == 0 && exceptions4c.blocks == 0;
+}
+
+/**
+ * Tests that the deadline stays disarmed after leaving nested blocks.
+ */
+static int nested(void) {
+    volatile int timed_out = 0, again = 0; /* NOSONAR */
+
+    TRY_WITHIN(10) {
+        TRY {
+            for (;;) {
+                /* wait for the signal */
+            }
+        }
+    } CATCH (TIMEOUT) {
+        timed_out = 1;
+#ifndef NDEBUG
+        timed_out = EXCEPTION.file == NULL && EXCEPTION.line == 0;
+#endif
+        skew += 2000;
+        TRY {
+            CHECKPOINT();
+        } CATCH (TIMEOUT) {
+            again = 1;
+        }
+    }
+    return timed_out && !again && exceptions4c.deadline == 0;
+}
+
+/**
+ * Tests macro DEADLINE_TIMER.
+ */
+int main(void) {
+    volatile int timed_out = 0; /* NOSONAR */
+    volatile unsigned long spins = 0; /* NOSONAR */
+
+    if (!DEADLINE_TIMER(1)) {
+        return EXIT_FAILURE;
+    }
+
+    TRY_WITHIN(10) {
+        for (;;) {
+            spins++;
+        }
+    } CATCH (TIMEOUT) {
+        timed_out = 1;
+        printf("Caught: %s: %s\n", EXCEPTION.name, EXCEPTION.message);
+    }
+
+    return !timed_out || !nested() || !DEADLINE_TIMER(0) || !entering();
+}
@@ -0,0 +1,69 @@
+/*
+ * Copyright 2025 Guillermo Calvo
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define EXCEPTIONS4C_DEADLINES 1
+#include <exceptions4c-lite.h>
+
+struct e4c_context exceptions4c = {0};
+const e4c_exception_type TIMEOUT = "Timeout";
+
+/**
+ * Tests that the deadline stays disarmed after leaving nested blocks.
+ */
+static int nested(void) {
+    volatile int timed_out = 0, again = 0; /* NOSONAR */
+
+    TRY_WITHIN(10) {
+        TRY {
+            for (;;) {
+                CHECKPOINT();
+            }
+        }
+    } CATCH (TIMEOUT) {
+        timed_out = 1;
+        TRY {
+            CHECKPOINT();
+        } CATCH (TIMEOUT) {
+            again = 1;
+        }
+    }
+    return timed_out && !again && exceptions4c.deadline == 0;
+}
+
+/**
+ * Tests macro TRY_WITHIN.
+ */
+int main(void) {
+    volatile int inherited = 0, disarmed = 0, timed_out = 0; /* NOSONAR */
+
+    TRY_WITHIN(10) {
+        unsigned long long outer = exceptions4c.deadline;
+        TRY_WITHIN(60000) {
+            inherited = exceptions4c.deadline == outer;
+            for (;;) {
+                CHECKPOINT();
+            }
+        } FINALLY {
+            disarmed = exceptions4c.deadline == 0;
+        }
+    } CATCH (TIMEOUT) {
+        timed_out = 1;
+        printf("Caught: %s: %s\n", EXCEPTION.name, EXCEPTION.message);
+    }
+
+    return !inherited || !disarmed || !timed_out || exceptions4c.deadline != 0
+        || !nested();
+}
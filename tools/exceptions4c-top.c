@@ -0,0 +1,269 @@
+/*
+ * Copyright 2025 Guillermo Calvo
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Shows the live exception statistics of a running process.
+ *
+ * Usage: exceptions4c-top [-d seconds] [-n iterations] [-r rows] pid
+ *
+ * The process MUST have been built with EXCEPTIONS4C_LIVE_STATS, and opened
+ * its segment via LIVE_STATS_OPEN. The layout of the segment is read from the
+ * segment itself, so any number of threads and sites is supported.
+ */
+
+#define EXCEPTIONS4C_LIVE_STATS 1
+#include <errno.h>
+#include <signal.h>
+#include <string.h>
+#include <time.h>
+#include <exceptions4c-lite.h>
+
+struct e4c_context exceptions4c = {0};
+
+/* Counters of a thread, or of a type or a site aggregated across threads */
+struct row {
+    char name[EXCEPTION_LIVE_NAME];
+    char file[EXCEPTION_LIVE_FILE];
+    int line;
+    unsigned depth;
+    unsigned max_depth;
+    unsigned long thrown;
+    unsigned long caught;
+    unsigned long last_thrown;
+    unsigned long last_caught;
+    double thrown_rate;
+    double caught_rate;
+};
+
+struct table {
+    struct row *row;
+    size_t count;
+    size_t capacity;
+};
+
+static const struct e4c_live_segment *segment;
+static struct e4c_live_thread *snapshot;
+static struct table threads, types, sites;
+
+/* Returns the row of a type or a site, adding it if needed */
+static struct row *find(struct table *table, const char *name,
+    const char *file, int line) {
+    struct row *row;
+    for (size_t index = 0; index < table->count; index++) {
+        row = &table->row[index];
+        if (row->line == line && strcmp(row->name, name) == 0
+            && strcmp(row->file, file) == 0) {
+            return row;
+        }
+    }
+    if (table->count == table->capacity) {
+        return NULL;
+    }
+    row = &table->row[table->count++];
+    (void) snprintf(row->name, sizeof(row->name), "%s", name);
+    (void) snprintf(row->file, sizeof(row->file), "%s", file);
+    row->line = line;
+    return row;
+}
+
+/* Computes the rates of a table, and remembers its counters */
+static void update(struct table *table, double elapsed) {
+    for (size_t index = 0; index < table->count; index++) {
+        struct row *row = &table->row[index];
+        row->thrown_rate = (double) (row->thrown - row->last_thrown) / elapsed;
+        row->caught_rate = (double) (row->caught - row->last_caught) / elapsed;
+        row->last_thrown = row->thrown;
+        row->last_caught = row->caught;
+    }
+}
+
+/* Sorts rows by throw rate, then by number of exceptions thrown */
+static int compare(const void *a, const void *b) {
+    const struct row *first = a, *second = b;
+    if (first->thrown_rate != second->thrown_rate) {
+        return first->thrown_rate < second->thrown_rate ? 1 : -1;
+    }
+    return (first->thrown < second->thrown) - (first->thrown > second->thrown);
+}
+
+/* Reads the statistics of every thread */
+static void sample(double elapsed, unsigned long *terminated,
+    unsigned long *dropped) {
+    unsigned attached = atomic_load((atomic_uint *) &segment->attached);
+    *terminated = *dropped = 0;
+    for (size_t index = 0; index < sites.count; index++) {
+        sites.row[index].thrown = sites.row[index].caught = 0;
+    }
+    for (size_t index = 0; index < types.count; index++) {
+        types.row[index].thrown = types.row[index].caught = 0;
+    }
+    for (unsigned index = 0; index < attached && index < segment->threads;
+        index++) {
+        struct row *row = &threads.row[index];
+        if (!LIVE_STATS_SNAPSHOT(segment, index, snapshot)) {
+            continue;
+        }
+        if (index >= threads.count) {
+            threads.count = index + 1;
+        }
+        (void) snprintf(row->name, sizeof(row->name), "#%u", index);
+        row->thrown = snapshot->thrown;
+        row->caught = snapshot->caught;
+        row->depth = atomic_load(&snapshot->depth);
+        row->max_depth = atomic_load(&snapshot->max_depth);
+        *terminated += snapshot->terminated;
+        *dropped += snapshot->dropped;
+        for (unsigned site = 0; site < segment->sites; site++) {
+            const struct e4c_live_site *live = &snapshot->site[site];
+            if (live->name[0] == '\0'
+                || (row = find(&sites, live->name, live->file, live->line))
+                == NULL) {
+                continue;
+            }
+            row->thrown += live->thrown;
+            row->caught += live->caught;
+        }
+    }
+    for (size_t index = 0; index < sites.count; index++) {
+        struct row *row = find(&types, sites.row[index].name, "", 0);
+        if (row == NULL) {
+            continue;
+        }
+        row->thrown += sites.row[index].thrown;
+        row->caught += sites.row[index].caught;
+    }
+    update(&threads, elapsed);
+    update(&types, elapsed);
+    update(&sites, elapsed);
+}
+
+/* Prints the statistics of every thread, type and site */
+static void print(long pid, int alive, double interval, size_t rows,
+    unsigned long terminated, unsigned long dropped) {
+    double thrown = 0, caught = 0;
+    for (size_t index = 0; index < threads.count; index++) {
+        thrown += threads.row[index].thrown_rate;
+        caught += threads.row[index].caught_rate;
+    }
+    if (isatty(STDOUT_FILENO)) {
+        printf("\033[H\033[2J");
+    }
+    printf("exceptions4c-top - pid %ld%s - %lu threads - every %.1fs\n", pid,
+        alive ? "" : " (exited)", (unsigned long) threads.count, interval);
+    printf("Thrown: %.1f/s, caught: %.1f/s, terminated: %lu, dropped: %lu\n",
+        thrown, caught, terminated, dropped);
+    printf("\n%-8s %6s %6s %12s %12s %12s\n", "THREAD", "DEPTH", "MAX",
+        "THROWN/S", "CAUGHT/S", "THROWN");
+    for (size_t index = 0; index < threads.count && index < rows; index++) {
+        const struct row *row = &threads.row[index];
+        printf("%-8s %6u %6u %12.1f %12.1f %12lu\n", row->name, row->depth,
+            row->max_depth, row->thrown_rate, row->caught_rate, row->thrown);
+    }
+    qsort(types.row, types.count, sizeof(struct row), compare);
+    printf("\n%-32s %12s %12s %12s\n", "TYPE", "THROWN/S", "CAUGHT/S",
+        "THROWN");
+    for (size_t index = 0; index < types.count && index < rows; index++) {
+        const struct row *row = &types.row[index];
+        printf("%-32s %12.1f %12.1f %12lu\n", row->name, row->thrown_rate,
+            row->caught_rate, row->thrown);
+    }
+    qsort(sites.row, sites.count, sizeof(struct row), compare);
+    printf("\n%-32s %-32s %12s %12s\n", "SITE", "TYPE", "THROWN/S",
+        "CAUGHT/S");
+    for (size_t index = 0; index < sites.count && index < rows; index++) {
+        const struct row *row = &sites.row[index];
+        char site[EXCEPTION_LIVE_FILE + 16];
+        (void) snprintf(site, sizeof(site), "%s:%d",
+            row->file[0] != '\0' ? row->file : "?", row->line);
+        printf("%-32s %-32s %12.1f %12.1f\n", site, row->name,
+            row->thrown_rate, row->caught_rate);
+    }
+    (void) fflush(stdout);
+}
+
+/* Returns the current time of a monotonic clock, in seconds */
+static double now(void) {
+    struct timespec time;
+    (void) clock_gettime(CLOCK_MONOTONIC, &time);
+    return (double) time.tv_sec + (double) time.tv_nsec / 1e9;
+}
+
+static int usage(void) {
+    (void) fprintf(stderr,
+        "Usage: exceptions4c-top [-d seconds] [-n iterations] [-r rows] pid\n");
+    return EXIT_FAILURE;
+}
+
+int main(int argc, char *argv[]) {
+    double interval = 1, last;
+    long iterations = 0, pid;
+    size_t rows = 10;
+    int option;
+    while ((option = getopt(argc, argv, "d:n:r:")) != -1) {
+        if (option == 'd') {
+            interval = strtod(optarg, NULL);
+        } else if (option == 'n') {
+            iterations = strtol(optarg, NULL, 10);
+        } else if (option == 'r') {
+            rows = (size_t) strtoul(optarg, NULL, 10);
+        } else {
+            return usage();
+        }
+    }
+    if (optind != argc - 1 || interval <= 0) {
+        return usage();
+    }
+    pid = strtol(argv[optind], NULL, 10);
+    segment = LIVE_STATS_MAP(pid);
+    if (segment == NULL) {
+        (void) fprintf(stderr, "exceptions4c-top: no live statistics for"
+            " process %ld\n", pid);
+        return EXIT_FAILURE;
+    }
+    snapshot = malloc(LIVE_STATS_THREAD_SIZE(segment));
+    threads.capacity = segment->threads;
+    sites.capacity = types.capacity = (size_t) segment->threads
+        * segment->sites;
+    threads.row = calloc(threads.capacity, sizeof(struct row));
+    types.row = calloc(types.capacity, sizeof(struct row));
+    sites.row = calloc(sites.capacity, sizeof(struct row));
+    if (snapshot == NULL || threads.row == NULL || types.row == NULL
+        || sites.row == NULL) {
+        return EXIT_FAILURE;
+    }
+    unsigned long terminated, dropped;
+    sample(1, &terminated, &dropped);
+    last = now();
+    for (long iteration = 0; iterations == 0 || iteration < iterations;
+        iteration++) {
+        struct timespec delay;
+        int alive;
+        double current;
+        delay.tv_sec = (time_t) interval;
+        delay.tv_nsec = (long) ((interval - (double) delay.tv_sec) * 1e9);
+        (void) nanosleep(&delay, NULL);
+        alive = kill((pid_t) pid, 0) == 0 || errno == EPERM;
+        current = now();
+        sample(current - last, &terminated, &dropped);
+        last = current;
+        print(pid, alive, interval, rows, terminated, dropped);
+        if (!alive) {
+            break;
+        }
+    }
+    LIVE_STATS_UNMAP(segment);
+    return EXIT_SUCCESS;
+}